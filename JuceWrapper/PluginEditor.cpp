@@ -80,6 +80,11 @@ NtPluginAudioProcessorEditor::NtPluginAudioProcessorEditor(
     auto minHeight = this->meters.getMinimalHeight();
     if (height < minHeight) { height = minHeight; }
   }
+#ifdef NTFX_PROFILE
+  height += profileHeight;
+  this->profileLabel.setJustificationType(juce::Justification::left);
+  this->addAndMakeVisible(this->profileLabel);
+#endif
   this->unscaledWindowHeight = height;
   this->updateUiScale();
   this->updateOversampling();
@@ -132,6 +137,7 @@ void NtPluginAudioProcessorEditor::initDropDown(
 void NtPluginAudioProcessorEditor::initRadioButton(
     NtFx::RadioButtonSetSpec& spec) {
   auto group = this->makeSmallToggleSet<NtFx::RadioButtonSet>(spec);
+  group->addChangeListener(this);
   for (size_t i = 0; i < spec.options.size(); i++) {
     this->toggleAttachments.emplace_back(
         new juce::AudioProcessorValueTreeState::ButtonAttachment(
@@ -165,7 +171,6 @@ std::unique_ptr<T> NtPluginAudioProcessorEditor::makeSmallToggleSet(
   auto group = std::make_unique<T>(spec, this->proc.plug.uiSpec);
   group->setTitle(spec.name);
   group->setName(spec.name);
-  group->addChangeListener(this);
   group->setColour(juce::Label::ColourIds::textColourId, juce::Colours::white);
   this->addAndMakeVisible(*group);
   return std::move(group);
@@ -199,7 +204,6 @@ void NtPluginAudioProcessorEditor::_initKnob(NtFx::KnobSpec<float>& spec,
   std::replace(name.begin(), name.end(), '_', ' ');
   p_slider->setTextValueSuffix(spec.suffix);
   p_slider->setSliderStyle(juce::Slider::SliderStyle::Rotary);
-  p_slider->addListener(this);
   this->addAndMakeVisible(p_slider.get());
   this->knobAttachments.emplace_back(
       new juce::AudioProcessorValueTreeState::SliderAttachment(
@@ -219,7 +223,6 @@ void NtPluginAudioProcessorEditor::_initToggle(
   this->addAndMakeVisible(p_toggle);
   p_toggle->setClickingTogglesState(true);
   p_toggle->setToggleable(true);
-  p_toggle->addListener(this);
   std::string name(spec.name);
   std::replace(name.begin(), name.end(), '_', ' ');
   p_toggle->setButtonText(name);
@@ -261,6 +264,12 @@ void NtPluginAudioProcessorEditor::updateUi() {
   if (this->proc.plug.uiSpec.includeTitleBar) { this->updateTitleBar(area); }
   this->pad = 10 * this->uiScale;
   area.reduce(this->pad, this->pad);
+#ifdef NTFX_PROFILE
+  this->profileLabel.setFont(juce::FontOptions(
+      this->proc.plug.uiSpec.defaultFontSize * this->uiScale * 0.7f));
+  this->profileLabel.setBounds(
+      area.removeFromBottom(int(profileHeight * this->uiScale)));
+#endif
   if (this->proc.plug.uiSpec.includeMeters
       && this->proc.plug.meters.size() != 0) {
     this->updateMeters(area);
@@ -497,70 +506,67 @@ void NtPluginAudioProcessorEditor::updateColours() {
 }
 
 void NtPluginAudioProcessorEditor::timerCallback() {
-  for (size_t i = 0; i < this->meters.size(); i++) {
-    this->meters.refresh(
-        i, this->proc.plug.getAndResetPeakLevel(i), this->proc.plug.getRms(i));
-  }
-  if (this->proc.plug.uiNeedsUpdate) {
-    this->updateUi();
-    this->proc.plug.uiNeedsUpdate = false;
-  }
-}
-
-void NtPluginAudioProcessorEditor::sliderValueChanged(juce::Slider* p_slider) {
-  auto name   = p_slider->getName().toStdString();
-  auto* p_val = this->proc.plug.getKnobValuePtr(name);
-  if (!p_val) {
-    DBG("Knob name in UI not found in plugin knobs.");
-    return;
+  auto& levels = this->meterLevels;
+  if (!this->proc.readMeters(levels)) {
+    // Nothing was processed since the last refresh, so the peaks fall.
+    for (size_t i = 0; i < levels.peak.size(); i++) {
+      levels.peak[i] = this->proc.plug.peakDefault(i);
+    }
   }
-  *p_val = p_slider->getValue();
-  this->proc.plug.update();
-}
-
-void NtPluginAudioProcessorEditor::buttonClicked(juce::Button* p_button) {
-  auto name   = p_button->getName().toStdString();
-  auto* p_val = this->proc.plug.getToggleValuePtr(name);
-  if (!p_val) {
-    DBG("Toggle name in UI not found in plugin toggles.");
-    return;
+  for (size_t i = 0; i < this->meters.size(); i++) {
+    auto rms = i < levels.rms.size() ? levels.rms[i] : NtFx::Stereo<float>(0);
+    this->meters.refresh(i, levels.peak[i], rms);
+  }
+  if (this->proc.plug.uiNeedsUpdate.exchange(false)) { this->updateUi(); }
+#ifdef NTFX_PROFILE
+  this->updateProfile();
+#endif
+}
+
+#ifdef NTFX_PROFILE
+void NtPluginAudioProcessorEditor::updateProfile() {
+  // Shows the time since the last refresh, i.e. the current load. Each stage
+  // is shown as a share of the whole processBlock() call.
+  auto current      = this->proc.getProfile().read();
+  auto entries      = NtFx::Profile::diff(current, this->lastProfile);
+  this->lastProfile = std::move(current);
+  uint64_t total    = 0;
+  for (const auto& e : entries) {
+    if (e.name == "processBlock") { total = e.ticks; }
+  }
+  if (!total) { return; }
+  juce::String text;
+  for (const auto& e : entries) {
+    if (text.isNotEmpty()) { text << "   "; }
+    if (e.name == "processBlock") {
+      text << "block " << juce::String(e.ticks / e.calls) << " "
+           << NtFx::Profile::tickUnit;
+    } else {
+      text << e.name << " " << juce::String(100.0 * e.ticks / total, 1) << "%";
+    }
   }
-  *p_val = p_button->getToggleState();
-  this->proc.plug.update();
+  this->profileLabel.setText(text, juce::dontSendNotification);
 }
+#endif
 
 void NtPluginAudioProcessorEditor::changeListenerCallback(
     juce::ChangeBroadcaster* p_b) {
-  for (size_t i = 0; i < this->proc.plug.radioButtons.size(); i++) {
-    auto& r = this->radioButtons[i];
+  for (auto& r : this->radioButtons) {
     if (p_b != r.get()) { continue; }
-    auto p_val = this->proc.plug.radioButtons[i].p_val;
-    if (!p_val) {
-      DBG("RadioButton value is null.");
-      continue;
-    }
-    *p_val = r->val;
-    this->proc.plug.update();
-    this->proc.plug.uiNeedsUpdate = true;
-    return;
-  }
-  // TODO: Look at this mess...
-  for (size_t i = 0; i < this->proc.plug.toggleSets.size(); i++) {
-    auto& g = this->toggleSets[i];
-    if (p_b != g.get()) { continue; }
-    for (size_t j = 0; j < this->proc.plug.toggleSets[i].toggles.size(); j++) {
-      auto& t = this->proc.plug.toggleSets[i].toggles[j];
-      if (!t.p_val) {
-        DBG("Toggle value in group is null.");
-        continue;
+    // Each option is a host parameter, and the audio thread reads the first
+    // one that is on. All of them are set, so exactly one is.
+    const auto& options = r->spec.options;
+    for (size_t i = 0; i < options.size(); i++) {
+      auto name = NtFx::makeTmpToggle(r->spec.name, options[i], "radioButton")
+                      .name;
+      auto p_param = this->proc.paramLayout.getParameter(name);
+      float val    = int(i) == r->val ? 1.0f : 0.0f;
+      if (p_param && p_param->getValue() != val) {
+        p_param->setValueNotifyingHost(val);
       }
-      *t.p_val = g->toggles[j]->getToggleState();
     }
-    this->proc.plug.update();
-    this->proc.plug.uiNeedsUpdate = true;
     return;
   }
-  DBG("RadioButton name in UI not found in plugin toggles.");
 }
 
 void NtPluginAudioProcessorEditor::comboBoxChanged(juce::ComboBox* p_box) {
@@ -572,11 +578,6 @@ void NtPluginAudioProcessorEditor::comboBoxChanged(juce::ComboBox* p_box) {
   if (p_box == this->titleBarDropDowns[e_oversampling].get()) {
     this->updateOversampling();
   }
-  auto name  = p_box->getName().toStdString();
-  auto p_val = this->proc.plug.getDropDownValuePtr(name);
-  if (!p_val) { return; }
-  *p_val = p_box->getSelectedId() - 1;
-  this->proc.plug.update();
 }
 
 void NtPluginAudioProcessorEditor::updateUiScale() {
@@ -51,8 +51,6 @@
 
 struct NtPluginAudioProcessorEditor : public juce::AudioProcessorEditor,
                                       private juce::Timer,
-                                      private juce::Slider::Listener,
-                                      private juce::ToggleButton::Listener,
                                       private juce::ComboBox::Listener,
                                       private juce::ChangeListener {
 
@@ -65,6 +63,7 @@ struct NtPluginAudioProcessorEditor : public juce::AudioProcessorEditor,
 
   NtPluginAudioProcessor& proc;
   NtFx::MeterGroup meters;
+  NtFx::MeterSnapshot<float> meterLevels; ///< Levels shown in the meters.
   NtFx::KnobLookAndFeel knobLookAndFeel;
   NtFx::TitleBarLookAndFeel dropDownLookAndFeel;
 
@@ -101,9 +100,13 @@ struct NtPluginAudioProcessorEditor : public juce::AudioProcessorEditor,
   bool isInitialized         = false;
 
   juce::Label pluginNameLabel;
+#ifdef NTFX_PROFILE
+  static constexpr int profileHeight = 20;
+  juce::Label profileLabel;
+  std::vector<NtFx::Profile::Entry> lastProfile;
+  void updateProfile();
+#endif
 
-  void sliderValueChanged(juce::Slider* slider) override;
-  void buttonClicked(juce::Button* button) override;
   void changeListenerCallback(juce::ChangeBroadcaster* source) override;
   void comboBoxChanged(juce::ComboBox* p_box) override;
   void timerCallback() override;
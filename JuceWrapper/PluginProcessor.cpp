@@ -25,6 +25,8 @@
 #include "lib/Stereo.h"
 #include "lib/UiSpec.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <string>
 #include <type_traits>
@@ -38,10 +40,15 @@ NtPluginAudioProcessor::NtPluginAudioProcessor()
       paramLayout(*this,
           nullptr,
           juce::Identifier(JucePlugin_Name),
-          createParameterLayout()),
-      src(plug) { }
+          createParameterLayout()) {
+  this->bindParameters();
+}
 
-NtPluginAudioProcessor::~NtPluginAudioProcessor() { }
+NtPluginAudioProcessor::~NtPluginAudioProcessor() {
+#ifdef NTFX_PROFILE
+  this->dumpProfile();
+#endif
+}
 
 const juce::String NtPluginAudioProcessor::getName() const {
   return JucePlugin_Name;
@@ -71,7 +78,9 @@ bool NtPluginAudioProcessor::isMidiEffect() const {
 #endif
 }
 
-double NtPluginAudioProcessor::getTailLengthSeconds() const { return 0.0; }
+double NtPluginAudioProcessor::getTailLengthSeconds() const {
+  return this->plug.getTailSeconds();
+}
 int NtPluginAudioProcessor::getNumPrograms() { return 1; }
 int NtPluginAudioProcessor::getCurrentProgram() { return 0; }
 void NtPluginAudioProcessor::setCurrentProgram(int index) { }
@@ -84,13 +93,38 @@ void NtPluginAudioProcessor::changeProgramName(
 void NtPluginAudioProcessor::prepareToPlay(
     double sampleRate, int samplesPerBlock) {
   this->fsBase = sampleRate;
+  this->engine.block.reserve(samplesPerBlock);
+  this->engineDouble.block.reserve(samplesPerBlock);
+  this->samplePos = 0;
+  // The host may have switched precision since the last call, so the engine
+  // about to process must have the current parameter values.
+  if (this->applyHostValues(this->engineDouble, false)) {
+    this->engineDouble.plug.update();
+  }
   this->updateOversampling();
-  this->plug.xRms[0].reset(sampleRate);
-  this->plug.xRms[1].reset(sampleRate);
 }
 
 juce::AudioChannelSet m_outputFormat;
-void NtPluginAudioProcessor::releaseResources() { }
+void NtPluginAudioProcessor::releaseResources() {
+#ifdef NTFX_PROFILE
+  this->dumpProfile();
+#endif
+}
+
+#ifdef NTFX_PROFILE
+const NtFx::Profile::Table& NtPluginAudioProcessor::getProfile() const {
+  return this->isUsingDoublePrecision() ? this->engineDouble.plug.profile
+                                        : this->plug.profile;
+}
+
+void NtPluginAudioProcessor::dumpProfile() const {
+  auto file = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                  .getChildFile(JucePlugin_Name "_profile.csv");
+  if (!this->getProfile().dump(file.getFullPathName().toStdString())) {
+    DBG("Could not write profile to " << file.getFullPathName());
+  }
+}
+#endif
 
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool NtPluginAudioProcessor::isBusesLayoutSupported(
@@ -114,7 +148,29 @@ bool NtPluginAudioProcessor::isBusesLayoutSupported(
 
 void NtPluginAudioProcessor::processBlock(
     juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+  this->processEngine(this->engine, buffer);
+}
+
+void NtPluginAudioProcessor::processBlock(
+    juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) {
+  // The UI reads the float plugin, so it follows the parameters without
+  // processing audio.
+  if (this->applyHostValues(this->engine, false)) {
+    this->plug.update();
+    this->plug.uiNeedsUpdate = true;
+  }
+  this->processEngine(this->engineDouble, buffer);
+}
+
+bool NtPluginAudioProcessor::supportsDoublePrecisionProcessing() const {
+  return true;
+}
+
+template <typename signal_t>
+void NtPluginAudioProcessor::processEngine(
+    NtPluginEngine<signal_t>& e, juce::AudioBuffer<signal_t>& buffer) {
   juce::ScopedNoDenormals noDenormals;
+  NTFX_PROFILE_SCOPE(e.plug.profile, "processBlock");
   auto totalNumInputChannels  = getTotalNumInputChannels();
   auto totalNumOutputChannels = getTotalNumOutputChannels();
   for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i) {
@@ -125,32 +181,60 @@ void NtPluginAudioProcessor::processBlock(
 
   if (p_posInfo) {
     auto tempo = p_posInfo->getBpm();
-    if (tempo && tempo != this->plug.tempo) {
-      this->plug.tempo = *tempo;
-      this->plug.onTempoChanged();
+    if (tempo && *tempo != e.plug.tempo) {
+      e.plug.tempo = signal_t(*tempo);
+      e.plug.onTempoChanged();
     }
   }
+  this->pollAutomation(e);
   auto leftBuffer  = buffer.getWritePointer(0);
   auto rightBuffer = buffer.getWritePointer(1);
 
-  bool scConnected = false;
-  const float* scBuffer;
+  // Everything that is fixed for the block is decided here, so the stages
+  // below run straight through each slice. The side chain is read in place
+  // from the host buffer, and 'block' interleaves the host channels chunk by
+  // chunk for the plugin to process in place.
+  const signal_t* scBuffer = nullptr;
   const auto& sidechainBus = this->getBusBuffer(buffer, true, 1);
   if (sidechainBus.getNumChannels() > 0) {
-    scConnected = true;
-    scBuffer    = sidechainBus.getReadPointer(0);
+    scBuffer = sidechainBus.getReadPointer(0);
   }
-  for (size_t i = 0; i < buffer.getNumSamples(); i++) {
-    NtFx::Stereo<float> x { leftBuffer[i], rightBuffer[i] };
-    if (scConnected) { this->plug.xSc = scBuffer[i]; }
-    auto y = this->src.process(x);
-    if (this->plug.meters.size() <= 2) {
-      if (this->plug.meters[0].addRms) { this->plug.xRms[0].process(x); }
-      if (this->plug.meters[1].addRms) { this->plug.xRms[1].process(y); }
-    }
-    leftBuffer[i]  = y.l;
-    rightBuffer[i] = y.r;
+  const auto& meters    = e.plug.meters;
+  const bool rmsIn      = meters.size() > 0 && meters[0].addRms;
+  const bool rmsOut     = meters.size() > 1 && meters[1].addRms;
+  bool peakIn = false, peakOut = false;
+  for (const auto& m : meters) {
+    peakIn  = peakIn || m.source == NtFx::MeterSource::input;
+    peakOut = peakOut || m.source == NtFx::MeterSource::output;
+  }
+  const size_t nSamples = buffer.getNumSamples();
+  auto processSlice     = [&](size_t iSlice, size_t nSlice) {
+    e.block.set(leftBuffer + iSlice, rightBuffer + iSlice, nSlice);
+    e.block.forEachChunk([&](NtFx::Stereo<signal_t>* p_x, size_t i0, size_t n) {
+      if (rmsIn) { e.plug.xRms[0].processDelayLineBlock(p_x, n); }
+      if (peakIn) { e.plug.meterBlock(NtFx::MeterSource::input, p_x, n); }
+      const auto p_sc = scBuffer ? scBuffer + iSlice + i0 : nullptr;
+      e.src.processBlock(p_x, p_x, n, p_sc);
+      if (rmsOut) { e.plug.xRms[1].processDelayLineBlock(p_x, n); }
+      if (peakOut) { e.plug.meterBlock(NtFx::MeterSource::output, p_x, n); }
+    });
+  };
+  // Slices are aligned to the host timeline when available, so automation
+  // renders the same in realtime and offline.
+  int64_t pos = this->samplePos;
+  if (p_posInfo) {
+    auto timeInSamples = p_posInfo->getTimeInSamples();
+    if (timeInSamples) { pos = *timeInSamples; }
+  }
+  e.automation.processBlock(e.plug, pos, nSamples, processSlice);
+  this->samplePos = pos + nSamples;
+  // Plugin latency may follow parameters, e.g. lookahead. The host is told
+  // from the message thread, also when the editor is closed.
+  const int latency = int(std::lround(e.src.getLatencySamples()));
+  if (this->latency.exchange(latency) != latency) {
+    this->triggerAsyncUpdate();
   }
+  e.plug.publishMeters(this->samplePos);
 }
 
 bool NtPluginAudioProcessor::hasEditor() const { return true; }
@@ -171,62 +255,151 @@ void NtPluginAudioProcessor::setStateInformation(
       getXmlFromBinary(data, sizeInBytes));
   if (xmlState.get() == nullptr) { return; }
   if (!xmlState->hasTagName(this->paramLayout.state.getType())) { return; }
+  // Values are written directly rather than ramped by Automation, so
+  // the audio thread must not run meanwhile.
+  this->suspendProcessing(true);
   this->paramLayout.replaceState(juce::ValueTree::fromXml(*xmlState));
-  this->loadParameter(this->plug.primaryKnobs);
-  this->loadParameter(this->plug.secondaryKnobs);
-  this->loadParameter(this->plug.toggles);
-  this->loadParameter(this->plug.dropdowns);
-  this->loadRadioButtons(this->plug.radioButtons);
-  this->loadToggleSets(this->plug.toggleSets);
+  this->applyHostValues(this->engine, false);
+  this->applyHostValues(this->engineDouble, false);
+  this->plug.update();
+  this->engineDouble.plug.update();
+  this->suspendProcessing(false);
   auto par = this->paramLayout.getParameterAsValue("Oversampling");
   auto val = par.getValue();
-  if (val) {
-    this->src.mode = NtFx::Src::oversamplingMode((int)val);
-    this->src.reset(this->fsBase);
-  }
+  if (val) { this->updateOversampling((int)val); }
 }
 
-template <typename T>
-void NtPluginAudioProcessor::loadParameter(std::vector<T>& v) {
-  for (auto& p : v) {
-    if (!p.p_val) { continue; }
-    auto par = this->paramLayout.getParameterAsValue(p.name);
-    *p.p_val = par.getValue();
-    DBG("Loaded '" << p.name << "': " << float(*p.p_val));
+void NtPluginAudioProcessor::bindParameters() {
+  const auto& registry = this->plug.paramRegistry;
+  this->hostParams.resize(registry.size());
+  size_t nKnobs = 0;
+  for (size_t id = 0; id < registry.size(); id++) {
+    const auto& ref = registry.refs[id];
+    auto& host      = this->hostParams[id];
+    if (ref.group == NtFx::ParamGroup::radioButtons) {
+      auto& r = this->plug.radioButtons[ref.idx];
+      for (auto& option : r.options) {
+        host.push_back(this->paramLayout.getRawParameterValue(
+            NtFx::makeTmpToggle(r.name, option, "radioButton").name));
+      }
+      continue;
+    }
+    host.push_back(this->paramLayout.getRawParameterValue(registry.names[id]));
+    if (ref.type == NtFx::ParamType::knob) { nKnobs++; }
   }
+  this->engine.automation.reserve(nKnobs);
+  this->engineDouble.automation.reserve(nKnobs);
 }
 
-void NtPluginAudioProcessor::loadRadioButtons(
-    std::vector<NtFx::RadioButtonSetSpec>& v) {
-  for (auto& p : v) {
-    int val;
-    for (size_t i = 0; i < p.options.size(); i++) {
-      auto par = this->paramLayout.getParameterAsValue(
-          NtFx::makeTmpToggle(p.name, p.options[i], "radioButton").name);
-      if (par.getValue()) { val = i; }
+bool NtPluginAudioProcessor::getHostValue(size_t id, float& val) const {
+  const auto& host = this->hostParams[id];
+  if (host.size() == 1) {
+    if (!host[0]) { return false; }
+    val = host[0]->load();
+    return true;
+  }
+  // Radio button set. The value is the index of the option that is on.
+  for (size_t i = 0; i < host.size(); i++) {
+    if (host[i] && host[i]->load() > 0.5f) {
+      val = float(i);
+      return true;
     }
-    *p.p_val = val + 1;
-    DBG("Loaded '" << p.name << "': " << float(*p.p_val));
   }
+  return false;
 }
 
-void NtPluginAudioProcessor::loadToggleSets(
-    std::vector<NtFx::ToggleSetSpec>& v) {
-  for (auto& p : v) {
-    for (size_t i = 0; i < p.toggles.size(); i++) {
-      auto mangledName =
-          NtFx::makeTmpToggle(p.name, p.toggles[i].name, "toggleGroup").name;
-      auto par            = this->paramLayout.getParameterAsValue(mangledName);
-      *p.toggles[i].p_val = par.getValue();
-      DBG("Loaded '" << mangledName << "': " << float(*p.toggles[i].p_val));
+template <typename signal_t>
+bool NtPluginAudioProcessor::applyHostValues(
+    NtPluginEngine<signal_t>& e, bool rampKnobs) {
+  bool changed = false;
+  for (size_t id = 0; id < this->hostParams.size(); id++) {
+    float val;
+    if (!this->getHostValue(id, val)) { continue; }
+    if (auto* p_knob = e.plug.getKnobValuePtr(int(id))) {
+      if (rampKnobs && !e.plug.getKnobSpec(int(id))->stepped) {
+        e.automation.setTarget(p_knob, signal_t(val));
+      } else if (*p_knob != signal_t(val)) {
+        *p_knob = signal_t(val);
+        changed = true;
+      }
+    } else if (auto* p_toggle = e.plug.getToggleValuePtr(int(id))) {
+      if (*p_toggle != (val > 0.5f)) {
+        *p_toggle = val > 0.5f;
+        changed   = true;
+      }
+    } else if (auto* p_option = e.plug.getOptionValuePtr(int(id))) {
+      if (*p_option != int(std::lround(val))) {
+        *p_option = int(std::lround(val));
+        changed   = true;
+      }
     }
   }
+  return changed;
+}
+
+template <typename signal_t>
+void NtPluginAudioProcessor::pollAutomation(NtPluginEngine<signal_t>& e) {
+  // The host parameters are the only source of parameter values, the UI is
+  // attached to them. Knobs ramp to new values over a fixed time, stepped
+  // knobs and everything else switch at the start of the block.
+  if (this->applyHostValues(e, true)) {
+    e.plug.update();
+    this->plug.uiNeedsUpdate = true;
+  }
+}
+
+bool NtPluginAudioProcessor::readMeters(NtFx::MeterSnapshot<float>& snapshot) {
+  if (!this->isUsingDoublePrecision()) {
+    return this->plug.readMeters(snapshot);
+  }
+  NtFx::MeterSnapshot<double> d;
+  if (!this->engineDouble.plug.readMeters(d)) { return false; }
+  snapshot.samplePos = d.samplePos;
+  for (size_t i = 0; i < d.peak.size(); i++) {
+    snapshot.peak[i] = { float(d.peak[i].l), float(d.peak[i].r) };
+  }
+  for (size_t i = 0; i < d.rms.size(); i++) {
+    snapshot.rms[i] = { float(d.rms[i].l), float(d.rms[i].r) };
+  }
+  return true;
 }
 
 void NtPluginAudioProcessor::updateOversampling(int mode) {
-  if (mode) { this->src.mode = NtFx::Src::oversamplingMode(mode); }
-  this->src.reset(this->fsBase);
-  this->plug.reset(this->src.coeffs.fsHi);
+  // The converter and the plugin are reallocated and cleared, which must not
+  // happen while the audio thread is using them.
+  this->suspendProcessing(true);
+  if (mode) {
+    this->engine.src.mode       = NtFx::Src::oversamplingMode(mode);
+    this->engineDouble.src.mode = NtFx::Src::oversamplingMode(mode);
+  }
+  this->resetEngine(this->engine);
+  this->resetEngine(this->engineDouble);
+  this->updateLatency();
+  this->suspendProcessing(false);
+}
+
+template <typename signal_t>
+void NtPluginAudioProcessor::resetEngine(NtPluginEngine<signal_t>& e) {
+  e.src.reset(this->fsBase);
+  e.plug.reset(e.src.coeffs.fsHi);
+  e.plug.xRms[0].reset(this->fsBase);
+  e.plug.xRms[1].reset(this->fsBase);
+  e.automation.reset(this->fsBase);
+}
+
+void NtPluginAudioProcessor::updateLatency() {
+  // Only called while processing is suspended, so the engines can be read.
+  this->latency = int(std::lround(this->isUsingDoublePrecision()
+          ? this->engineDouble.src.getLatencySamples()
+          : this->engine.src.getLatencySamples()));
+  this->handleAsyncUpdate();
+}
+
+void NtPluginAudioProcessor::handleAsyncUpdate() {
+  const int latency = this->latency.load();
+  if (latency != this->getLatencySamples()) {
+    this->setLatencySamples(latency);
+  }
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter() {
@@ -31,6 +31,8 @@ const int versionNumber         = 0x100;
 #endif
 
 #include NTFX_PLUGIN_FILE
+#include "lib/Automation.h"
+#include "lib/PlanarBlock.h"
 #include "lib/SampleRateConverter.h"
 #include "lib/UiSpec.h"
 
@@ -48,10 +50,25 @@ const int versionNumber         = 0x100;
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 
+/**
+ * @brief The plugin with its sample rate converter, buffers and automation at
+ * one processing precision.
+ */
+template <typename signal_t>
+struct NtPluginEngine {
+  NTFX_PLUGIN<signal_t> plug;
+  NtFx::Src::SampleRateConverter<signal_t> src;
+  NtFx::PlanarBlock<signal_t> block; ///< Host channels, run in chunks.
+  NtFx::Automation<signal_t> automation;
+
+  NtPluginEngine() : src(plug) { }
+};
+
 //==============================================================================
 /**
  */
-struct NtPluginAudioProcessor : public juce::AudioProcessor {
+struct NtPluginAudioProcessor : public juce::AudioProcessor,
+                                private juce::AsyncUpdater {
   NtPluginAudioProcessor();
   ~NtPluginAudioProcessor() override;
   void prepareToPlay(double sampleRate, int samplesPerBlock) override;
@@ -62,6 +79,8 @@ struct NtPluginAudioProcessor : public juce::AudioProcessor {
 #endif
 
   void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+  void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+  bool supportsDoublePrecisionProcessing() const override;
 
   juce::AudioProcessorEditor* createEditor() override;
   bool hasEditor() const override;
@@ -82,24 +101,50 @@ struct NtPluginAudioProcessor : public juce::AudioProcessor {
   void getStateInformation(juce::MemoryBlock& destData) override;
   void setStateInformation(const void* data, int sizeInBytes) override;
 
-  template <typename T>
-  void loadParameter(std::vector<T>& v);
-  void loadRadioButtons(std::vector<NtFx::RadioButtonSetSpec>& v);
-  void loadToggleSets(std::vector<NtFx::ToggleSetSpec>& v);
 
   template <typename t_val, typename t_spec>
   void createParameters(std::vector<t_spec>& vParams,
       juce::AudioProcessorValueTreeState::ParameterLayout& parameters,
       int& i);
 
+  template <typename signal_t>
+  void processEngine(
+      NtPluginEngine<signal_t>& e, juce::AudioBuffer<signal_t>& buffer);
+  template <typename signal_t>
+  void resetEngine(NtPluginEngine<signal_t>& e);
   void updateOversampling(int mode = 0);
+  void updateLatency();
+  void handleAsyncUpdate() override;
+#ifdef NTFX_PROFILE
+  const NtFx::Profile::Table& getProfile() const;
+  void dumpProfile() const;
+#endif
+  void bindParameters();
+  bool getHostValue(size_t id, float& val) const;
+  template <typename signal_t>
+  bool applyHostValues(NtPluginEngine<signal_t>& e, bool rampKnobs);
+  template <typename signal_t>
+  void pollAutomation(NtPluginEngine<signal_t>& e);
+  bool readMeters(NtFx::MeterSnapshot<float>& snapshot);
   juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
   NtFx::TitleBarSpec titleBarSpec;
   float fsBase = 48000;
-  NTFX_PLUGIN<float> plug;
-  NtFx::Src::SampleRateConverter<float> src;
+  /** Processes when the host runs in single precision. Its plugin holds the
+   * parameter values shown in the UI, whichever engine processes. */
+  NtPluginEngine<float> engine;
+  /** Processes when the host runs in double precision. */
+  NtPluginEngine<double> engineDouble;
+  NTFX_PLUGIN<float>& plug = engine.plug;
   juce::AudioProcessorValueTreeState paramLayout;
+
+  /** Host parameters by plugin parameter ID. Radio button sets have one per
+   * option. */
+  std::vector<std::vector<std::atomic<float>*>> hostParams;
+  int64_t samplePos = 0;
+  /** Latency of the engine processing, in samples at the base rate. Written
+   * by the audio thread and reported to the host from the message thread. */
+  std::atomic<int> latency { 0 };
   // std::vector<std::vector<bool>> dummyBools;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NtPluginAudioProcessor)
@@ -102,8 +102,10 @@ struct RadioButtonSet : public ToggleSetBase {
       auto option   = spec.options[i];
       auto p_toggle = this->makeToggle(option);
       p_toggle->setRadioGroupId(id++);
+      // Clicks also come from the host parameter attachments, which turn the
+      // other options off, so only an option turned on is selected.
       p_toggle->onClick = [this, i]() {
-        this->val = i;
+        if (this->toggles[i]->getToggleState()) { this->val = i; }
         this->sendChangeMessage();
       };
       toggles.push_back(std::move(p_toggle));
@@ -0,0 +1,166 @@
+#pragma once
+
+/**
+ * @file Automation.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Sample accurate parameter automation by slicing blocks.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NtFx {
+
+/**
+ * @brief Ramps knob values to new targets over a fixed time. Blocks with
+ * ramps running are split into slices of 'sliceLen' samples, aligned to
+ * multiples of 'sliceLen' on the timeline, and before each slice the knobs are
+ * set to their interpolated value at the end of the slice and update() is
+ * called. Coefficients are thereby only recalculated at slice boundaries. The
+ * boundaries and the slope of the ramps do not depend on the buffer size of
+ * the host, so realtime playback and offline bounces render the same. Blocks
+ * without ramps running are processed in one go.
+ *
+ * @tparam signal_t Audio datatype.
+ */
+template <typename signal_t>
+struct Automation {
+  /**
+   * @brief A knob moving from 'start' to 'target' over 'rampLen' samples.
+   */
+  struct Ramp {
+    signal_t* p_val;
+    signal_t start;
+    signal_t target;
+    size_t nDone; ///< Samples of the ramp processed so far.
+  };
+
+  /**
+   * @brief Slice length in samples. 0 disables slicing, in which case the
+   * knobs move once per block.
+   */
+  size_t sliceLen { 32 };
+
+  /**
+   * @brief Time it takes a knob to reach a new target. Applied by reset().
+   */
+  float rampTime_ms { 10 };
+
+  /**
+   * @brief Ramp length in samples. Set by reset().
+   */
+  size_t rampLen { 480 };
+
+  /**
+   * @brief Knobs currently ramping.
+   */
+  std::vector<Ramp> ramps;
+
+  /**
+   * @brief Allocates room for ramping all knobs. Call this outside the audio
+   * thread.
+   *
+   * @param nKnobs Number of knobs.
+   */
+  void reserve(size_t nKnobs) { this->ramps.reserve(nKnobs); }
+
+  /**
+   * @brief Ends all ramps at their targets and sets the ramp length.
+   *
+   * @param fs Sample rate of the blocks passed to processBlock().
+   */
+  void reset(float fs) noexcept {
+    for (auto& r : this->ramps) { *r.p_val = r.target; }
+    this->ramps.clear();
+    this->rampLen = std::max(size_t(1),
+        size_t(std::lround(this->rampTime_ms * 1e-3f * fs)));
+  }
+
+  /**
+   * @brief Ramps a knob to a new value, starting at the next block. A knob
+   * already ramping starts over from where it is.
+   *
+   * @param p_val Knob value.
+   * @param target Value at the end of the ramp.
+   */
+  void setTarget(signal_t* p_val, signal_t target) noexcept {
+    for (auto& r : this->ramps) {
+      if (r.p_val == p_val) {
+        if (r.target != target) { r = { p_val, *p_val, target, 0 }; }
+        return;
+      }
+    }
+    if (*p_val == target) { return; }
+    if (this->ramps.size() == this->ramps.capacity()) {
+      // No room without allocating, so jump instead.
+      *p_val = target;
+      return;
+    }
+    this->ramps.push_back({ p_val, *p_val, target, 0 });
+  }
+
+  /**
+   * @brief Processes a block in slices while ramps are running.
+   *
+   * @param c Component to update before each slice, usually the plugin.
+   * @param pos Position of the first sample of the block on the timeline.
+   * @param n Number of samples in the block.
+   * @param process Called as process(i0, m) for each slice of 'm' samples
+   * starting at sample 'i0' of the block.
+   */
+  template <typename component_t, typename process_t>
+  void processBlock(
+      component_t& c, int64_t pos, size_t n, process_t&& process) noexcept {
+    const size_t sliceLen = this->sliceLen ? this->sliceLen : n;
+    for (size_t i0 = 0; i0 < n;) {
+      if (this->ramps.empty()) {
+        process(i0, n - i0);
+        return;
+      }
+      int64_t offset = pos % int64_t(sliceLen);
+      if (offset < 0) { offset += sliceLen; }
+      // The knobs get their values at the end of the whole slice, also when
+      // the block ends before it, so short blocks do not add steps.
+      const size_t toEnd = sliceLen - size_t(offset);
+      const size_t m     = std::min(toEnd, n - i0);
+      for (auto& r : this->ramps) {
+        const auto a = signal_t(std::min(r.nDone + toEnd, this->rampLen))
+            / signal_t(this->rampLen);
+        *r.p_val = r.start + (r.target - r.start) * a;
+        r.nDone += m;
+      }
+      c.update();
+      process(i0, m);
+      for (size_t k = 0; k < this->ramps.size();) {
+        if (this->ramps[k].nDone < this->rampLen) {
+          k++;
+          continue;
+        }
+        *this->ramps[k].p_val = this->ramps[k].target;
+        this->ramps[k]        = this->ramps.back();
+        this->ramps.pop_back();
+      }
+      i0 += m;
+      pos += m;
+    }
+  }
+};
+}
@@ -18,7 +18,10 @@
 #pragma once
 
 #include "lib/Component.h"
+#include "lib/Simd.h"
 #include "lib/Stereo.h"
+#include <array>
+#include <cstddef>
 
 #include "gcem.hpp"
 
@@ -74,19 +77,74 @@ namespace Biquad {
     State<signal_t> state;
     Biquad6(Coeffs6<signal_t>& coeffs) : coeffs(coeffs) { }
     inline signal_t process(signal_t x) {
-      signal_t y = (this->coeffs.b[0] * x + this->coeffs.b[1] * this->state.x[0]
-                       + this->coeffs.b[2] * this->state.x[1]
-                       - this->coeffs.a[1] * this->state.y[0]
-                       - this->coeffs.a[2] * this->state.y[1])
-          / this->coeffs.a[0];
-      this->state.y[1] = this->state.y[0];
-      this->state.y[0] = y;
-      this->state.x[1] = this->state.x[0];
-      this->state.x[0] = x;
+      return _biquad6(this->coeffs, this->state, x);
+    }
+    static inline signal_t _biquad6(
+        const Coeffs6<signal_t>& c, State<signal_t>& s, signal_t x) {
+      signal_t y = (c.b[0] * x + c.b[1] * s.x[0] + c.b[2] * s.x[1]
+                       - c.a[1] * s.y[0] - c.a[2] * s.y[1])
+          / c.a[0];
+      s.y[1] = s.y[0];
+      s.y[0] = y;
+      s.x[1] = s.x[0];
+      s.x[0] = x;
       return y;
     }
   };
 
+  /**
+   * @brief Runs a stereo biquad over a block with both channels in one
+   * register. Same difference equation as _biquad5() and _biquad6().
+   *
+   * @tparam signal_t Audio datatype.
+   * @tparam coeffs_t Coeffs5 or Coeffs6.
+   * @param cl Left coefficients.
+   * @param cr Right coefficients.
+   * @param sl Left state.
+   * @param sr Right state.
+   * @param x Input samples.
+   * @param y Output samples. May be the same buffer as 'x'.
+   * @param n Number of samples.
+   */
+  template <typename signal_t, typename coeffs_t>
+  static inline void _biquadBlock(const coeffs_t& cl,
+      const coeffs_t& cr,
+      State<signal_t>& sl,
+      State<signal_t>& sr,
+      const Stereo<signal_t>* x,
+      Stereo<signal_t>* y,
+      size_t n) noexcept {
+    using vec_t = Simd::StereoVec<signal_t>;
+    constexpr bool isCoeffs6 = std::is_same_v<coeffs_t, Coeffs6<signal_t>>;
+    constexpr size_t iA      = isCoeffs6 ? 1 : 0;
+    const auto b0            = vec_t::set(cl.b[0], cr.b[0]);
+    const auto b1            = vec_t::set(cl.b[1], cr.b[1]);
+    const auto b2            = vec_t::set(cl.b[2], cr.b[2]);
+    const auto a1            = vec_t::set(cl.a[iA], cr.a[iA]);
+    const auto a2            = vec_t::set(cl.a[iA + 1], cr.a[iA + 1]);
+    [[maybe_unused]] const auto a0 = vec_t::set(cl.a[0], cr.a[0]);
+    auto x1 = vec_t::set(sl.x[0], sr.x[0]);
+    auto x2 = vec_t::set(sl.x[1], sr.x[1]);
+    auto y1 = vec_t::set(sl.y[0], sr.y[0]);
+    auto y2 = vec_t::set(sl.y[1], sr.y[1]);
+    for (size_t i = 0; i < n; i++) {
+      const auto xn = vec_t::load(x + i);
+      auto yn       = b0 * xn + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+      if constexpr (isCoeffs6) { yn = yn / a0; }
+      x2 = x1;
+      x1 = xn;
+      y2 = y1;
+      y1 = yn;
+      yn.store(y + i);
+    }
+    const auto _x1 = x1.toStereo();
+    const auto _x2 = x2.toStereo();
+    const auto _y1 = y1.toStereo();
+    const auto _y2 = y2.toStereo();
+    sl             = { { _x1.l, _x2.l }, { _y1.l, _y2.l } };
+    sr             = { { _x1.r, _x2.r }, { _y1.r, _y2.r } };
+  }
+
   template <typename signal_t>
   struct BiQuad6Stereo : public Component<Stereo<signal_t>> {
     Settings<signal_t> settings;
@@ -97,6 +155,12 @@ namespace Biquad {
     virtual Stereo<signal_t> process(Stereo<signal_t> x) noexcept override {
       return { this->l.process(x.l), this->r.process(x.r) };
     }
+    virtual void processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept override {
+      _biquadBlock(this->coeffs, this->coeffs, this->l.state, this->r.state, x,
+          y, n);
+    }
     virtual void update() noexcept override {
       this->coeffs = calcCoeffs6<signal_t>(settings, this->fs);
     }
@@ -107,14 +171,16 @@ namespace Biquad {
     Coeffs5<signal_t> coeffs;
     State<signal_t> state;
     inline signal_t process(signal_t x) {
-      signal_t y = this->coeffs.b[0] * x + this->coeffs.b[1] * this->state.x[0]
-          + this->coeffs.b[2] * this->state.x[1]
-          - this->coeffs.a[0] * this->state.y[0]
-          - this->coeffs.a[1] * this->state.y[1];
-      this->state.y[1] = this->state.y[0];
-      this->state.y[0] = y;
-      this->state.x[1] = this->state.x[0];
-      this->state.x[0] = x;
+      return _biquad5(this->coeffs, this->state, x);
+    }
+    static inline signal_t _biquad5(
+        const Coeffs5<signal_t>& c, State<signal_t>& s, signal_t x) {
+      signal_t y = c.b[0] * x + c.b[1] * s.x[0] + c.b[2] * s.x[1]
+          - c.a[0] * s.y[0] - c.a[1] * s.y[1];
+      s.y[1] = s.y[0];
+      s.y[0] = y;
+      s.x[1] = s.x[0];
+      s.x[0] = x;
       return y;
     }
     inline void update(Settings<signal_t>& settings, signal_t fs) {
@@ -130,6 +196,12 @@ namespace Biquad {
     virtual Stereo<signal_t> process(Stereo<signal_t> x) noexcept override {
       return { l.process(x.l), r.process(x.r) };
     }
+    virtual void processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept override {
+      _biquadBlock(this->l.coeffs, this->r.coeffs, this->l.state,
+          this->r.state, x, y, n);
+    }
     virtual void update() noexcept override {
       this->l.update(this->settings, this->fs);
       this->r.update(this->settings, this->fs);
@@ -327,6 +399,238 @@ namespace Biquad {
     return c;
   }
 
+  /**
+   * @brief How the bands of a Bank are connected.
+   */
+  enum class Topology {
+    serial,   ///< Each band filters the output of the band before it.
+    parallel, ///< Every band filters the input. The outputs are summed.
+  };
+
+  /**
+   * @brief A number of biquads run as one component, e.g. the bands of a
+   * parametric EQ. Coefficients and state are stored as structure of arrays
+   * with one frame per band, so processBlock() runs as many bands at once as
+   * Simd::FrameVec holds frames.
+   *
+   * In parallel, all bands see the same input and simply run side by side. In
+   * serial, band k runs one sample behind band k - 1, so that the input of
+   * every band in a register is ready at the same time. The pipeline is
+   * filled at the start of every block and drained at the end, so the bank
+   * adds no latency.
+   *
+   * Bands with Shape::none pass the signal in serial and add nothing in
+   * parallel. Call update() after changing the topology.
+   *
+   * @tparam signal_t Audio datatype.
+   * @tparam nBands Number of bands.
+   */
+  template <typename signal_t, size_t nBands>
+  struct Bank : public Component<Stereo<signal_t>> {
+    using vec_t = Simd::FrameVec<signal_t>;
+    static constexpr size_t nFrames = vec_t::nFrames;
+    /** Bands rounded up to whole registers. Sections past the bands are off.*/
+    static constexpr size_t nSections
+        = (nBands + nFrames - 1) / nFrames * nFrames;
+    static constexpr size_t nVecs = nSections / nFrames;
+
+    Topology topology { Topology::serial };
+    std::array<Settings<signal_t>, nBands> settings;
+
+    // Coeffs5 and State of all sections. Left and right share a frame.
+    std::array<Stereo<signal_t>, nSections> b0;
+    std::array<Stereo<signal_t>, nSections> b1;
+    std::array<Stereo<signal_t>, nSections> b2;
+    std::array<Stereo<signal_t>, nSections> a1;
+    std::array<Stereo<signal_t>, nSections> a2;
+    std::array<Stereo<signal_t>, nSections> x1;
+    std::array<Stereo<signal_t>, nSections> x2;
+    std::array<Stereo<signal_t>, nSections> y1;
+    std::array<Stereo<signal_t>, nSections> y2;
+
+    virtual Stereo<signal_t> process(Stereo<signal_t> x) noexcept override {
+      if (this->topology == Topology::parallel) {
+        Stereo<signal_t> y(0);
+        for (size_t k = 0; k < nSections; k++) {
+          y = y + this->_section(k, x);
+        }
+        return y;
+      }
+      for (size_t k = 0; k < nSections; k++) { x = this->_section(k, x); }
+      return x;
+    }
+
+    virtual void processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept override {
+      if (this->topology == Topology::parallel) {
+        this->_processParallel(x, y, n);
+      } else {
+        this->_processSerial(x, y, n);
+      }
+    }
+
+    virtual void update() noexcept override {
+      for (size_t k = 0; k < nSections; k++) {
+        Coeffs5<signal_t> c;
+        if (k < nBands && this->settings[k].shape != Shape::none) {
+          c = calcCoeffs5<signal_t>(this->settings[k], this->fs);
+        } else if (this->topology == Topology::parallel) {
+          c.b[0] = 0;
+        }
+        this->b0[k] = c.b[0];
+        this->b1[k] = c.b[1];
+        this->b2[k] = c.b[2];
+        this->a1[k] = c.a[0];
+        this->a2[k] = c.a[1];
+      }
+    }
+
+    virtual void reset(float fs) noexcept override {
+      this->fs = fs;
+      this->x1.fill(0);
+      this->x2.fill(0);
+      this->y1.fill(0);
+      this->y2.fill(0);
+      this->update();
+    }
+
+    /**
+     * @brief One sample of one section. Same difference equation as
+     * Biquad5::_biquad5(), but the input is added last. In the serial
+     * pipeline the input is the output of the section before, so this keeps
+     * it off most of the dependency chain. Summed in the same order as
+     * _step(), so process() and processBlock() give the same result.
+     */
+    inline Stereo<signal_t> _section(size_t k, Stereo<signal_t> x) noexcept {
+      const auto y = this->b1[k] * this->x1[k] + this->b2[k] * this->x2[k]
+          - this->a1[k] * this->y1[k] - this->a2[k] * this->y2[k]
+          + this->b0[k] * x;
+      this->x2[k] = this->x1[k];
+      this->x1[k] = x;
+      this->y2[k] = this->y1[k];
+      this->y1[k] = y;
+      return y;
+    }
+
+    /**
+     * @brief Coefficients and state of all sections in registers, for the
+     * duration of a block.
+     */
+    struct Vecs {
+      std::array<vec_t, nVecs> b0, b1, b2, a1, a2, x1, x2, y1, y2;
+    };
+
+    inline Vecs _loadVecs() const noexcept {
+      Vecs v;
+      for (size_t g = 0; g < nVecs; g++) {
+        const size_t k = g * nFrames;
+        v.b0[g]        = vec_t::load(&this->b0[k]);
+        v.b1[g]        = vec_t::load(&this->b1[k]);
+        v.b2[g]        = vec_t::load(&this->b2[k]);
+        v.a1[g]        = vec_t::load(&this->a1[k]);
+        v.a2[g]        = vec_t::load(&this->a2[k]);
+        v.x1[g]        = vec_t::load(&this->x1[k]);
+        v.x2[g]        = vec_t::load(&this->x2[k]);
+        v.y1[g]        = vec_t::load(&this->y1[k]);
+        v.y2[g]        = vec_t::load(&this->y2[k]);
+      }
+      return v;
+    }
+
+    inline void _storeState(const Vecs& v) noexcept {
+      for (size_t g = 0; g < nVecs; g++) {
+        const size_t k = g * nFrames;
+        v.x1[g].store(&this->x1[k]);
+        v.x2[g].store(&this->x2[k]);
+        v.y1[g].store(&this->y1[k]);
+        v.y2[g].store(&this->y2[k]);
+      }
+    }
+
+    /**
+     * @brief One sample of the sections in register g. With 'masked', only
+     * the sections set in 'm' advance their state.
+     */
+    template <bool masked>
+    static inline vec_t _step(Vecs& v,
+        size_t g,
+        vec_t x,
+        typename vec_t::mask_t m = typename vec_t::mask_t()) noexcept {
+      const auto y = v.b1[g] * v.x1[g] + v.b2[g] * v.x2[g]
+          - v.a1[g] * v.y1[g] - v.a2[g] * v.y2[g] + v.b0[g] * x;
+      if constexpr (masked) {
+        v.x2[g] = vec_t::select(m, v.x1[g], v.x2[g]);
+        v.x1[g] = vec_t::select(m, x, v.x1[g]);
+        v.y2[g] = vec_t::select(m, v.y1[g], v.y2[g]);
+        v.y1[g] = vec_t::select(m, y, v.y1[g]);
+      } else {
+        v.x2[g] = v.x1[g];
+        v.x1[g] = x;
+        v.y2[g] = v.y1[g];
+        v.y1[g] = y;
+      }
+      return y;
+    }
+
+    void _processParallel(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept {
+      auto v = this->_loadVecs();
+      for (size_t i = 0; i < n; i++) {
+        const auto xn = vec_t::splat(x[i]);
+        auto acc      = vec_t::splat(0);
+        for (size_t g = 0; g < nVecs; g++) {
+          acc = acc + _step<false>(v, g, xn);
+        }
+        y[i] = acc.sum();
+      }
+      this->_storeState(v);
+    }
+
+    /**
+     * @brief Serial bank as a pipeline. In step j, section k processes sample
+     * j - k, which is the output of section k - 1 from step j - 1. Sections
+     * with no sample in a step, while the pipeline fills and drains, keep
+     * their state.
+     */
+    void _processSerial(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept {
+      if (!n) { return; }
+      auto v = this->_loadVecs();
+      std::array<vec_t, nVecs> in;
+      std::array<vec_t, nVecs> out;
+      in.fill(vec_t::splat(0));
+      in[0] = vec_t::shift(vec_t::splat(x[0]), in[0]);
+      for (size_t j = 0; j < n + nSections - 1; j++) {
+        if (j + 1 >= nSections && j < n) {
+          for (size_t g = 0; g < nVecs; g++) {
+            out[g] = _step<false>(v, g, in[g]);
+          }
+        } else {
+          for (size_t g = 0; g < nVecs; g++) {
+            bool active[nFrames];
+            for (size_t f = 0; f < nFrames; f++) {
+              const size_t k = g * nFrames + f;
+              active[f]      = k <= j && j < k + n;
+            }
+            out[g] = _step<true>(v, g, in[g], vec_t::mask(active));
+          }
+        }
+        for (size_t g = nVecs - 1; g > 0; g--) {
+          in[g] = vec_t::shift(out[g - 1], out[g]);
+        }
+        const auto xNext = j + 1 < n ? x[j + 1] : Stereo<signal_t>(0);
+        in[0]            = vec_t::shift(vec_t::splat(xNext), out[0]);
+        if (j + 1 >= nSections) {
+          y[j + 1 - nSections] = out[nVecs - 1].last();
+        }
+      }
+      this->_storeState(v);
+    }
+  };
+
 } // namespace Biquad
 } // namespace NtFx
 
@@ -24,11 +24,21 @@
 #include "lib/Component.h"
 #include "lib/PeakSensor.h"
 #include "lib/RmsSensor.h"
+#include "lib/SlidingMax.h"
+#include "lib/TruePeak.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
 #include "lib/Stereo.h"
 #include "lib/utils.h"
 
 namespace NtFx {
 namespace Comp {
+  /**
+   * @brief Longest lookahead of the side chains in milliseconds.
+   */
+  constexpr double maxLookahead_ms = 10;
+
   /**
    * @brief Side chain settings structure
    *
@@ -40,14 +50,15 @@ namespace Comp {
    */
   template <typename signal_t>
   struct ScSettings {
-    signal_t thresh_db = signal_t(0);    ///< Threshold in dB
-    signal_t ratio_db  = signal_t(2);    ///< Compression ratio
-    signal_t knee_db   = signal_t(12);   ///< Knee width in dB
-    signal_t tAtt_ms   = signal_t(1);    ///< Attack time in milliseconds
-    signal_t tRel_ms   = signal_t(100);  ///< Release time in milliseconds
-    signal_t tRms_ms   = signal_t(80);   ///< RMS time constant in milliseconds
-    signal_t tPeak_ms  = signal_t(20.0); ///< Peak time constant in milliseconds
-    bool linkEnable    = false;
+    signal_t thresh_db     = signal_t(0);    ///< Threshold in dB
+    signal_t ratio_db      = signal_t(2);    ///< Compression ratio
+    signal_t knee_db       = signal_t(12);   ///< Knee width in dB
+    signal_t tAtt_ms       = signal_t(1);    ///< Attack time in milliseconds
+    signal_t tRel_ms       = signal_t(100);  ///< Release time in milliseconds
+    signal_t tRms_ms       = signal_t(80);   ///< RMS time constant in ms
+    signal_t tPeak_ms      = signal_t(20.0); ///< Peak time constant in ms
+    signal_t tLookahead_ms = signal_t(0);    ///< Lookahead in milliseconds
+    bool linkEnable        = false;
   };
 
   /**
@@ -57,11 +68,22 @@ namespace Comp {
    * gain reduction in the dB domain. It includes attack and release time
    * constants for dynamic control.
    *
+   * With a lookahead, the peak sensor is fed the maximum over the last
+   * 'tLookahead_ms', so a transient is seen that long before it reaches the
+   * audio. The side chain does not delay the audio itself. Delay the audio
+   * path, and any dry signal, by getLatencySamples().
+   *
+   * processBlock() runs the sensors block by block and does not call
+   * process(), so a derived class overriding process() must override
+   * processBlock() too.
+   *
    * @tparam signal_t The signal type (e.g., float, double)
+   * @tparam math_t dB conversions, ExactMath or FastMath.
    */
-  template <typename signal_t>
+  template <typename signal_t, typename math_t = ExactMath>
   struct PeakSideChainDb : public Component<Stereo<signal_t>> {
     PeakSensorStereo<signal_t> peakSensor; ///< Peak sensor for stereo signals
+    SlidingMaxStereo<signal_t> lookahead;  ///< Peak over the lookahead
     signal_t alphaAtt = signal_t(0);       ///< Attack coefficient
     signal_t alphaRel = signal_t(0);       ///< Release coefficient
 
@@ -73,7 +95,9 @@ namespace Comp {
      * @brief Constructor
      * @param settings Reference to side chain settings
      */
-    PeakSideChainDb(ScSettings<signal_t>& settings) : settings(settings) { }
+    PeakSideChainDb(ScSettings<signal_t>& settings) : settings(settings) {
+      this->lookahead.setMaxT_ms(maxLookahead_ms);
+    }
 
     /**
      * @brief Process stereo audio signal
@@ -81,7 +105,7 @@ namespace Comp {
      * @return Gain reduction in linear domain.
      */
     virtual Stereo<signal_t> process(Stereo<signal_t> x) noexcept override {
-      auto ySens = this->peakSensor.process(x);
+      auto ySens = this->peakSensor.process(this->_lookahead(x));
       ensureFinite(this->stateFilter);
       auto y = Stereo<signal_t>({
           this->_gainComputer_db(ySens.l, this->stateFilter.l),
@@ -94,6 +118,22 @@ namespace Comp {
       return y;
     }
 
+    /**
+     * @brief Process a block of stereo samples
+     * @param x Input stereo signal
+     * @param y Gain reduction in linear domain
+     * @param n Number of samples
+     */
+    virtual void processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept override {
+      this->_processBlock(x, y, n, [this](signal_t level, signal_t& state) {
+        return this->_gainComputer_db(level, state);
+      });
+      if (!this->settings.linkEnable) { return; }
+      for (size_t i = 0; i < n; i++) { y[i] = y[i].absMin(); }
+    }
+
     /**
      * @brief Update component coefficients.
      */
@@ -103,6 +143,8 @@ namespace Comp {
       if (this->alphaRel < this->alphaAtt) { this->alphaRel = this->alphaAtt; }
       this->peakSensor.setT_ms(this->settings.tPeak_ms);
       this->peakSensor.update();
+      this->lookahead.setT_ms(this->settings.tLookahead_ms);
+      this->lookahead.update();
     }
 
     /**
@@ -111,10 +153,61 @@ namespace Comp {
      */
     virtual void reset(float fs) noexcept override {
       this->peakSensor.reset(fs);
-      this->fs = fs;
+      this->fs          = fs;
+      this->stateFilter = signal_t(0);
+      this->lookahead.reset(fs);
       this->update();
     }
 
+    /**
+     * @brief Lookahead in samples. Delay the audio by this much.
+     */
+    size_t getLatencySamples() const noexcept {
+      return this->lookahead.l.nWindow - 1;
+    }
+
+    /**
+     * @brief Runs the lookahead, the peak sensor and a gain computer over a
+     * block in one pass, with the sensor and filter states in locals.
+     * @param x Input stereo signal
+     * @param y Gain reduction in linear domain
+     * @param n Number of samples
+     * @param gainComputer Called as gainComputer(level, state) per channel.
+     */
+    template <typename gainComputer_t>
+    inline void _processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n,
+        gainComputer_t&& gainComputer) noexcept {
+      using sensor_t    = PeakSensor<signal_t>;
+      auto& l           = this->peakSensor.l;
+      auto& r           = this->peakSensor.r;
+      const auto alphaL = l._alpha, alphaR = r._alpha;
+      auto sensL = l._state, sensR = r._state;
+      auto state = this->stateFilter;
+      const bool hasLookahead = this->lookahead.l.nWindow > 1;
+      for (size_t i = 0; i < n; i++) {
+        auto xi = x[i];
+        if (hasLookahead) { xi = this->lookahead.process(xi.abs()); }
+        const auto ySensL = sensor_t::_peakSensor(alphaL, sensL, xi.l);
+        const auto ySensR = sensor_t::_peakSensor(alphaR, sensR, xi.r);
+        ensureFinite(state);
+        y[i] = { gainComputer(ySensL, state.l), gainComputer(ySensR, state.r) };
+      }
+      l._state          = sensL;
+      r._state          = sensR;
+      this->stateFilter = state;
+    }
+
+    /**
+     * @brief Peak of the lookahead window, or the input without lookahead.
+     * @param x Input stereo signal
+     */
+    inline Stereo<signal_t> _lookahead(Stereo<signal_t> x) noexcept {
+      if (this->lookahead.l.nWindow <= 1) { return x; }
+      return this->lookahead.process(x.abs());
+    }
+
     /**
      * @brief Compute gain reduction in dB domain
      * @param x Input signal level
@@ -122,7 +215,7 @@ namespace Comp {
      * @return Gain reduction factor
      */
     inline signal_t _gainComputer_db(signal_t x, signal_t& state) noexcept {
-      signal_t x_db = db(x);
+      signal_t x_db = math_t::db(x);
       signal_t y_db;
       if ((x_db - this->settings.thresh_db) > (this->settings.knee_db / 2)) {
         y_db = this->settings.thresh_db
@@ -143,7 +236,7 @@ namespace Comp {
       signal_t yFilter = state * alpha + target * (1 - alpha);
       if (yFilter != yFilter) { yFilter = signal_t(0); }
       state = yFilter;
-      return invDb(-yFilter);
+      return math_t::invDb(-yFilter);
     }
   };
 
@@ -155,9 +248,10 @@ namespace Comp {
    * linear domain calculations.
    *
    * @tparam signal_t The signal type (e.g., float, double)
+   * @tparam math_t dB conversions, ExactMath or FastMath.
    */
-  template <typename signal_t>
-  struct PeakSideChainLinear : public PeakSideChainDb<signal_t> {
+  template <typename signal_t, typename math_t = ExactMath>
+  struct PeakSideChainLinear : public PeakSideChainDb<signal_t, math_t> {
     signal_t thresh_lin = signal_t(1); ///< Threshold in linear domain
     signal_t ratio_lin  = signal_t(1); ///< Compression ratio in linear domain
     signal_t knee_lin   = signal_t(1); ///< Knee width in linear domain
@@ -167,7 +261,7 @@ namespace Comp {
      * @param settings Reference to side chain settings
      */
     PeakSideChainLinear(ScSettings<signal_t>& settings)
-        : PeakSideChainDb<signal_t>(settings) { }
+        : PeakSideChainDb<signal_t, math_t>(settings) { }
 
     /**
      * @brief Process stereo audio signal
@@ -176,7 +270,7 @@ namespace Comp {
      * chain.
      */
     virtual Stereo<signal_t> process(Stereo<signal_t> x) noexcept override {
-      auto ySens = this->peakSensor.process(x);
+      auto ySens = this->peakSensor.process(this->_lookahead(x));
       ensureFinite(this->stateFilter);
       return {
         this->_gainComputer_lin(ySens.l, this->stateFilter.l),
@@ -184,11 +278,25 @@ namespace Comp {
       };
     }
 
+    /**
+     * @brief Process a block of stereo samples
+     * @param x Input stereo signal
+     * @param y Gain reduction in linear domain
+     * @param n Number of samples
+     */
+    virtual void processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept override {
+      this->_processBlock(x, y, n, [this](signal_t level, signal_t& state) {
+        return this->_gainComputer_lin(level, state);
+      });
+    }
+
     /**
      * @brief Update component coefficients
      */
     virtual void update() noexcept override {
-      this->PeakSideChainDb<signal_t>::update();
+      this->PeakSideChainDb<signal_t, math_t>::update();
       this->thresh_lin            = invDb(this->settings.thresh_db);
       this->knee_lin              = invDb(this->settings.knee_db);
       const signal_t oneOverSqrt2 = 1.0 / gcem::sqrt(2.0);
@@ -231,9 +339,10 @@ namespace Comp {
    * detection capabilities.
    *
    * @tparam signal_t The signal type (e.g., float, double)
+   * @tparam math_t dB conversions, ExactMath or FastMath.
    */
-  template <typename signal_t>
-  struct RmsSideChainDb : public PeakSideChainDb<signal_t> {
+  template <typename signal_t, typename math_t = ExactMath>
+  struct RmsSideChainDb final : public PeakSideChainDb<signal_t, math_t> {
     RmsSensorStereo<signal_t> rmsSensor; ///< RMS sensor for stereo signals
 
     /**
@@ -241,7 +350,7 @@ namespace Comp {
      * @param settings Reference to side chain settings
      */
     RmsSideChainDb(ScSettings<signal_t>& settings)
-        : PeakSideChainDb<signal_t>(settings) { }
+        : PeakSideChainDb<signal_t, math_t>(settings) { }
 
     /**
      * @brief Process stereo audio signal
@@ -258,13 +367,27 @@ namespace Comp {
       };
     }
 
+    /**
+     * @brief Process a block of stereo samples
+     * @param x Input stereo signal
+     * @param y Gain reduction in linear domain
+     * @param n Number of samples
+     */
+    virtual void processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept override {
+      for (size_t i = 0; i < n; i++) {
+        y[i] = this->process(x[i]);
+      }
+    }
+
     /**
      * @brief Update component parameters
      */
     virtual void update() noexcept override {
       this->rmsSensor.setT_ms(this->settings.tRms_ms);
       this->rmsSensor.update();
-      this->PeakSideChainDb<signal_t>::update();
+      this->PeakSideChainDb<signal_t, math_t>::update();
     }
 
     /**
@@ -273,7 +396,7 @@ namespace Comp {
      */
     virtual void reset(float fs) noexcept override {
       this->rmsSensor.reset(fs);
-      this->PeakSideChainDb<signal_t>::reset(fs);
+      this->PeakSideChainDb<signal_t, math_t>::reset(fs);
     }
   };
 
@@ -285,9 +408,11 @@ namespace Comp {
    * RMS detection capabilities.
    *
    * @tparam signal_t The signal type (e.g., float, double)
+   * @tparam math_t dB conversions, ExactMath or FastMath.
    */
-  template <typename signal_t>
-  struct RmsSideChainLinear : public PeakSideChainLinear<signal_t> {
+  template <typename signal_t, typename math_t = ExactMath>
+  struct RmsSideChainLinear final
+      : public PeakSideChainLinear<signal_t, math_t> {
     RmsSensorStereo<signal_t> rmsSensor; ///< RMS sensor for stereo signals
 
     /**
@@ -295,7 +420,7 @@ namespace Comp {
      * @param settings Reference to side chain settings
      */
     RmsSideChainLinear(ScSettings<signal_t>& settings)
-        : PeakSideChainLinear<signal_t>(settings) { }
+        : PeakSideChainLinear<signal_t, math_t>(settings) { }
 
     /**
      * @brief Process stereo audio signal
@@ -311,13 +436,27 @@ namespace Comp {
       };
     }
 
+    /**
+     * @brief Process a block of stereo samples
+     * @param x Input stereo signal
+     * @param y Gain reduction in linear domain
+     * @param n Number of samples
+     */
+    virtual void processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept override {
+      for (size_t i = 0; i < n; i++) {
+        y[i] = this->process(x[i]);
+      }
+    }
+
     /**
      * @brief Update component parameters
      */
     virtual void update() noexcept override {
       this->rmsSensor.setT_ms(this->settings.tRms_ms);
       this->rmsSensor.update();
-      this->PeakSideChainLinear<signal_t>::update();
+      this->PeakSideChainLinear<signal_t, math_t>::update();
     }
 
     /**
@@ -326,7 +465,164 @@ namespace Comp {
      */
     virtual void reset(float fs) noexcept override {
       this->rmsSensor.reset(fs);
-      this->PeakSideChainLinear<signal_t>::reset(fs);
+      this->PeakSideChainLinear<signal_t, math_t>::reset(fs);
+    }
+  };
+  /**
+   * @brief Brickwall limiter side chain. Uses 'thresh_db' as the ceiling and
+   * 'tLookahead_ms', 'tRel_ms' and 'linkEnable' from the settings.
+   *
+   * The gain reduction needed by each sample is held for the lookahead by a
+   * sliding maximum and then averaged over the lookahead, so the gain ramps
+   * down over the lookahead and has fully reached the hold value when the
+   * peak arrives at the delayed audio. The release is smoothed on top of that
+   * but never lets the gain above what the average asks for, so no peak is let
+   * through. With 'truePeakEnable', the ceiling applies to the true peak
+   * rather than the sample peak.
+   *
+   * Delay the audio by getLatencySamples() and multiply by the output.
+   *
+   * @tparam signal_t The signal type (e.g., float, double)
+   * @tparam math_t dB conversions, ExactMath or FastMath.
+   */
+  template <typename signal_t, typename math_t = ExactMath>
+  struct LimiterSideChain final : public Component<Stereo<signal_t>> {
+    TruePeak<signal_t> truePeak;     ///< True peak estimator
+    SlidingMaxStereo<signal_t> hold; ///< Holds the gain reduction
+    std::vector<Stereo<signal_t>> avgDLine; ///< Gain reductions to average
+    Stereo<signal_t> avgAccum = signal_t(0); ///< Sum of 'avgDLine'
+    size_t avgIdx             = 0;           ///< Index in 'avgDLine'
+    size_t nLookahead         = 0;           ///< Lookahead in samples
+    signal_t alphaRel         = signal_t(0); ///< Release coefficient
+    Stereo<signal_t> state    = signal_t(0); ///< Gain reduction in dB
+    bool truePeakEnable       = true;        ///< Limit the true peak.
+
+    ScSettings<signal_t>& settings; ///< Reference to side chain settings
+
+    /**
+     * @brief Constructor
+     * @param settings Reference to side chain settings
+     */
+    LimiterSideChain(ScSettings<signal_t>& settings) : settings(settings) {
+      // One sample of headroom for the extra sample held below.
+      this->hold.setMaxT_ms(maxLookahead_ms + 1);
+    }
+
+    /**
+     * @brief Process stereo audio signal
+     * @param x Input stereo signal
+     * @return Gain in linear domain.
+     */
+    virtual Stereo<signal_t> process(Stereo<signal_t> x) noexcept override {
+      auto xTp = this->truePeak.process(x);
+      auto xPk = this->truePeakEnable ? xTp : x.abs();
+      auto gr  = Stereo<signal_t>({
+          std::max(math_t::db(xPk.l) - this->settings.thresh_db, signal_t(0)),
+          std::max(math_t::db(xPk.r) - this->settings.thresh_db, signal_t(0)),
+      });
+      auto grAvg = this->_average(this->hold.process(gr));
+      ensureFinite(this->state);
+      this->state = {
+        this->_release(grAvg.l, this->state.l),
+        this->_release(grAvg.r, this->state.r),
+      };
+      if (this->settings.linkEnable) {
+        auto _gr = std::max(this->state.l, this->state.r);
+        return { math_t::invDb(-_gr), math_t::invDb(-_gr) };
+      }
+      return { math_t::invDb(-this->state.l), math_t::invDb(-this->state.r) };
+    }
+
+    /**
+     * @brief Process a block of stereo samples
+     * @param x Input stereo signal
+     * @param y Gain in linear domain
+     * @param n Number of samples
+     */
+    virtual void processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept override {
+      for (size_t i = 0; i < n; i++) {
+        y[i] = this->process(x[i]);
+      }
+    }
+
+    /**
+     * @brief Update component coefficients. Changing the lookahead restarts
+     * the average.
+     */
+    virtual void update() noexcept override {
+      this->alphaRel = gcem::exp(-2200.0 / (this->settings.tRel_ms * this->fs));
+      size_t n = 0;
+      if (this->settings.tLookahead_ms > 0) {
+        n = size_t(std::lround(this->settings.tLookahead_ms * this->fs / 1000));
+      }
+      n = std::min(n, this->avgDLine.size() - 1);
+      // A sample of the audio spans two true peak estimates.
+      this->hold.setWindowSamples(n + 2);
+      if (n == this->nLookahead) { return; }
+      this->nLookahead = n;
+      this->avgIdx     = 0;
+      this->avgAccum   = signal_t(0);
+      std::fill(this->avgDLine.begin(), this->avgDLine.end(), signal_t(0));
+    }
+
+    /**
+     * @brief Reset component with new sample rate
+     * @param fs Sample rate in Hz
+     */
+    virtual void reset(float fs) noexcept override {
+      this->fs = fs;
+      this->truePeak.reset(fs);
+      this->hold.reset(fs);
+      this->avgDLine.assign(
+          size_t(std::lround(maxLookahead_ms * fs / 1000)) + 1, signal_t(0));
+      this->nLookahead = 0;
+      this->avgIdx     = 0;
+      this->avgAccum   = signal_t(0);
+      this->state      = signal_t(0);
+      this->update();
+    }
+
+    /**
+     * @brief Delay of the gain relative to the input in samples.
+     */
+    size_t getLatencySamples() const noexcept {
+      return this->nLookahead
+          + (this->truePeakEnable ? TruePeak<signal_t>::getLatency() : 0);
+    }
+
+    /**
+     * @brief Moving average over the lookahead plus one samples. The sum is
+     * recalculated every time the delay line wraps, so rounding errors do not
+     * build up.
+     * @param x Gain reduction in dB
+     * @return Average gain reduction
+     */
+    inline Stereo<signal_t> _average(Stereo<signal_t> x) noexcept {
+      const size_t nAvg = this->nLookahead + 1;
+      this->avgAccum += x - this->avgDLine[this->avgIdx];
+      this->avgDLine[this->avgIdx] = x;
+      if (++this->avgIdx >= nAvg) {
+        this->avgIdx   = 0;
+        this->avgAccum = signal_t(0);
+        for (size_t i = 0; i < nAvg; i++) {
+          this->avgAccum += this->avgDLine[i];
+        }
+      }
+      return this->avgAccum / signal_t(nAvg);
+    }
+
+    /**
+     * @brief Follows rising gain reduction instantly and falling gain
+     * reduction with the release time.
+     * @param x Average gain reduction in dB
+     * @param state Previous output
+     * @return Smoothed gain reduction in dB
+     */
+    inline signal_t _release(signal_t x, signal_t state) const noexcept {
+      if (x >= state) { return x; }
+      return state * this->alphaRel + x * (1 - this->alphaRel);
     }
   };
 } // namespace NtFx
@@ -26,6 +26,7 @@
  */
 
 #include "lib/Stereo.h"
+#include <cstddef>
 
 namespace NtFx {
 /**
@@ -50,6 +51,20 @@ struct Component {
    */
   virtual T process(T x) noexcept = 0;
 
+  /**
+   * @brief Processes a block of samples. Defaults to calling process() for
+   * every sample. Override this in components where state can be kept in
+   * registers across the block or where the per-sample virtual call is
+   * significant. 'x' and 'y' may point to the same buffer.
+   *
+   * @param x Input samples.
+   * @param y Output samples.
+   * @param n Number of samples in block.
+   */
+  virtual void processBlock(const T* x, T* y, size_t n) noexcept {
+    for (size_t i = 0; i < n; i++) { y[i] = this->process(x[i]); }
+  }
+
   /**
    * @brief Called when ever a parameter (knob or toggle) changes. Update your
    * coefficients here.
@@ -85,6 +100,14 @@ struct StereoComponent : public Component<Stereo<signal_t>> {
     return { this->l.process(x.l), this->r.process(x.r) };
   }
 
+  virtual void processBlock(const Stereo<signal_t>* x,
+      Stereo<signal_t>* y,
+      size_t n) noexcept override {
+    for (size_t i = 0; i < n; i++) {
+      y[i] = { this->l.process(x[i].l), this->r.process(x[i].r) };
+    }
+  }
+
   virtual void update() noexcept override {
     this->l.update();
     this->r.update();
@@ -0,0 +1,312 @@
+#pragma once
+
+/**
+ * @file ComponentBench.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Throughput benchmarks of audio components.
+ * @details The performance counterpart of ComponentTest. Benchmarks are
+ * specified in 'testWrapper/bench' as cpp files named after the header they
+ * cover appended '_bench.cpp' and are built with optimization by
+ * 'testWrapper/test.py bench'. Every object is timed with process() called
+ * per sample and with processBlock() in blocks of BENCH_BLOCK_SIZE, using the
+ * 'dynamic_alternating' stimulus from 'testWrapper/in'. Each benchmark is
+ * timed a number of runs, and the median and the median absolute deviation
+ * of the runs are appended to 'testWrapper/out/bench.csv'.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lib/Component.h"
+#include "lib/Stereo.h"
+#include "lib/TestVector.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64)
+  #include <xmmintrin.h>
+#endif
+
+consteval auto benchFileBaseName(std::string_view fileName) {
+  auto _begin =
+      fileName.find("bench/") + std::char_traits<char>::length("bench/");
+  auto baseName = fileName.substr(_begin);
+  return baseName.substr(0, baseName.find("_bench"));
+}
+
+#define _NTFX_BENCH_QUOTE(str) #str
+#define _NTFX_BENCH_EXPAND_AND_QUOTE(str) _NTFX_BENCH_QUOTE(str)
+
+/**
+ * @brief Add this to the beginning of a benchmark file. Declares the set the
+ * benchmarks are added to, named after the file.
+ */
+#define NTFX_BENCH_BEGIN                                                       \
+  auto componentBenchSet                                                       \
+      = NtFx::ComponentBenchSet(std::string(benchFileBaseName(__FILE__)));
+
+/**
+ * @brief Main function of a benchmark program. Takes '--runs N'.
+ */
+#define NTFX_BENCH() int main(int argc, char** argv)
+
+/**
+ * @brief Adds a Component to the benchmarks. The object is NOT copied and
+ * must stay in scope until the benchmarks have run.
+ */
+#define NTFX_ADD_BENCH(object)                                                 \
+  componentBenchSet.add(object, _NTFX_BENCH_EXPAND_AND_QUOTE(object))
+
+/**
+ * @brief Runs all benchmarks added to the set.
+ */
+#define NTFX_RUN_BENCHES() componentBenchSet.runAll(argc, argv)
+
+namespace NtFx {
+/**
+ * @brief Block size used when timing processBlock(). Small, as in a host
+ * running at low latency, where the cost per block matters the most.
+ */
+constexpr size_t BENCH_BLOCK_SIZE = 64;
+
+/**
+ * @brief Each benchmark runs the stimulus over and over for at least this
+ * long.
+ */
+constexpr double BENCH_MIN_TIME_S = 0.1;
+
+/**
+ * @brief Default number of times each benchmark is timed. The runs are
+ * interleaved, so that a slow period on the machine hits all benchmarks
+ * rather than all runs of one.
+ */
+constexpr size_t BENCH_N_RUNS = 5;
+
+/**
+ * @brief Median of a number of values.
+ */
+inline double _benchMedian(std::vector<double> v) {
+  if (v.empty()) { return 0; }
+  const size_t i = v.size() / 2;
+  std::nth_element(v.begin(), v.begin() + i, v.end());
+  if (v.size() % 2) { return v[i]; }
+  return (v[i] + *std::max_element(v.begin(), v.begin() + i)) / 2;
+}
+
+/**
+ * @brief Median absolute deviation from the median. Unlike the standard
+ * deviation, a single run disturbed by the OS does not move it.
+ */
+inline double _benchMad(const std::vector<double>& v) {
+  const double median = _benchMedian(v);
+  std::vector<double> deviations;
+  for (auto x : v) { deviations.push_back(std::abs(x - median)); }
+  return _benchMedian(deviations);
+}
+
+template <typename T>
+T _benchSampleType(const Component<T>&);
+
+template <typename signal_t>
+inline void _benchConvert(Stereo<double> x, Stereo<signal_t>& y) {
+  y = { signal_t(x.l), signal_t(x.r) };
+}
+
+template <typename signal_t>
+inline void _benchConvert(Stereo<double> x, signal_t& y) {
+  y = signal_t(x.l);
+}
+
+/**
+ * @brief Set of benchmarks. Represents a full benchmark file.
+ */
+struct ComponentBenchSet {
+  /**
+   * @brief A single benchmark. 'pass' processes the whole stimulus once.
+   */
+  struct Bench {
+    std::string objName;         ///< Object timed.
+    std::string method;          ///< 'process' or 'processBlock'.
+    std::function<void()> reset; ///< Puts the object in its initial state.
+    std::function<void()> pass;  ///< Processes the stimulus once.
+  };
+
+  std::string name;                     ///< Name of set of benchmarks.
+  std::vector<Stereo<double>> stimulus; ///< Input to all benchmarks.
+  std::vector<Bench> benches;           ///< Benchmarks to run.
+
+  /**
+   * @brief Construct a new Component Bench Set object.
+   *
+   * @param name Name of the set. Used to identify results.
+   */
+  ComponentBenchSet(std::string name) : name(name) {
+    std::string error;
+    if (!TestVector::load(
+            "testWrapper/in/dynamic_alternating", this->stimulus, error)) {
+      std::cout << "Stimulus: " << error
+                << " Run 'testWrapper/test.py generate'.\n";
+    }
+  }
+
+  /**
+   * @brief Adds a benchmark of anything that processes samples of type T.
+   *
+   * @param objName Name of object.
+   * @param reset Called before timing. Must reset and update the object.
+   * @param process Called as process(x) for every sample.
+   * @param processBlock Called as processBlock(x, y, n).
+   */
+  template <typename T, typename process_t, typename processBlock_t>
+  void add(std::string objName,
+      std::function<void()> reset,
+      process_t process,
+      processBlock_t processBlock) {
+    auto x = std::make_shared<std::vector<T>>(this->stimulus.size());
+    auto y = std::make_shared<std::vector<T>>(this->stimulus.size());
+    for (size_t i = 0; i < x->size(); i++) {
+      _benchConvert(this->stimulus[i], (*x)[i]);
+    }
+    auto perSample = [=]() {
+      auto& _x = *x;
+      auto& _y = *y;
+      for (size_t i = 0; i < _x.size(); i++) { _y[i] = process(_x[i]); }
+    };
+    auto perBlock = [=]() {
+      for (size_t i = 0; i < x->size(); i += BENCH_BLOCK_SIZE) {
+        auto n = std::min(BENCH_BLOCK_SIZE, x->size() - i);
+        processBlock(x->data() + i, y->data() + i, n);
+      }
+    };
+    this->benches.push_back({ objName, "process", reset, perSample });
+    this->benches.push_back({ objName, "processBlock", reset, perBlock });
+  }
+
+  /**
+   * @brief Adds a benchmark of a Component. process() and processBlock() are
+   * called on the type of the object, not through Component, so that the
+   * compiler can inline them as it would in a plugin. Where they are not
+   * public, they are called through Component.
+   *
+   * @param cut Component to time.
+   * @param objName Name of object.
+   */
+  template <typename component_t>
+  void add(component_t& cut, std::string objName) {
+    using T      = decltype(_benchSampleType(cut));
+    auto& base   = static_cast<Component<T>&>(cut);
+    auto reset   = [&cut]() { cut.reset(NTFX_FS); };
+    auto process = [&cut, &base](T x) {
+      if constexpr (requires { cut.component_t::process(x); }) {
+        return cut.component_t::process(x);
+      } else {
+        return base.process(x);
+      }
+    };
+    auto processBlock = [&cut, &base](const T* x, T* y, size_t n) {
+      if constexpr (requires { cut.component_t::processBlock(x, y, n); }) {
+        cut.component_t::processBlock(x, y, n);
+      } else {
+        base.processBlock(x, y, n);
+      }
+    };
+    this->add<T>(objName, reset, process, processBlock);
+  }
+
+  /**
+   * @brief Times a benchmark.
+   *
+   * @return double Time per sample in nanoseconds.
+   */
+  double _time(Bench& bench) {
+    using clock = std::chrono::steady_clock;
+    bench.reset();
+    bench.pass();
+    size_t nPasses = 0;
+    const auto t0  = clock::now();
+    auto t1        = t0;
+    do {
+      bench.pass();
+      nPasses++;
+      t1 = clock::now();
+    } while (std::chrono::duration<double>(t1 - t0).count()
+        < BENCH_MIN_TIME_S);
+    const double t_ns
+        = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    return t_ns / double(nPasses * this->stimulus.size());
+  }
+
+  /**
+   * @brief Runs all benchmarks, prints the results and appends them to
+   * 'testWrapper/out/bench.csv'.
+   *
+   * @param argc Number of command line arguments.
+   * @param argv Command line arguments. '--runs N' sets the number of runs.
+   * @return int 0 on success, 1 if there was nothing to run.
+   */
+  int runAll(int argc = 0, char** argv = nullptr) {
+    if (this->stimulus.empty() || this->benches.empty()) { return 1; }
+    size_t nRuns = BENCH_N_RUNS;
+    for (int i = 1; i + 1 < argc; i++) {
+      if (std::string_view(argv[i]) == "--runs") {
+        nRuns = size_t(std::max(1, std::atoi(argv[i + 1])));
+      }
+    }
+#if defined(__SSE__) || defined(_M_X64)
+    // Flush denormals to zero, as the plugin wrappers do.
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+#endif
+    std::vector<std::vector<double>> ns(this->benches.size());
+    for (size_t iRun = 0; iRun < nRuns; iRun++) {
+      for (size_t i = 0; i < this->benches.size(); i++) {
+        ns[i].push_back(this->_time(this->benches[i]));
+      }
+    }
+    const auto csvPath = "testWrapper/out/bench.csv";
+    const bool isNew   = !std::filesystem::exists(csvPath);
+    std::ofstream csv(csvPath, std::ios_base::app);
+    if (isNew) {
+      csv << "set,object,method,ns_per_sample,mad_ns,realtime,runs\n";
+    }
+    csv << std::fixed;
+    for (size_t i = 0; i < this->benches.size(); i++) {
+      const auto& bench     = this->benches[i];
+      const double median   = _benchMedian(ns[i]);
+      const double mad      = _benchMad(ns[i]);
+      const double realtime = 1e9 / (median * NTFX_FS);
+      std::cout << std::fixed << std::setprecision(2) << this->name << "."
+                << bench.objName << " " << bench.method << ": " << median
+                << " +/- " << mad << " ns/sample, " << std::setprecision(0)
+                << realtime << "x realtime.\n";
+      csv << this->name << "," << bench.objName << "," << bench.method << ","
+          << std::setprecision(3) << median << "," << mad << ","
+          << std::setprecision(1) << realtime << "," << nRuns << "\n";
+    }
+    return 0;
+  }
+};
+}
@@ -10,8 +10,9 @@
  * named after the Component to test appended '_test.cpp'. Inputs are stored in
  * 'testWrapper/in' and results are stored in 'testWrapper/out'. 'in' is under
  * git source control since it contains expected test vectors along with
- * stimuli. Input and output files must contain two columns of floating point
- * numbers.
+ * stimuli. Inputs and outputs are stored in the binary format of
+ * 'lib/TestVector.h'. Inputs in the old text format, two columns of floating
+ * point numbers, are converted when first read.
  *
  * @copyright Copyright (c) 2026
  *
@@ -35,6 +36,7 @@
 
 #include "lib/Component.h"
 #include "lib/Stereo.h"
+#include "lib/TestVector.h"
 #include <algorithm>
 #include <cstring>
 #include <filesystem>
@@ -109,6 +111,14 @@ static const std::vector<std::string> STIMULI_NAMES { "impulse",
 
 constexpr char SEPARATOR = '.';
 
+/**
+ * @brief Every other block of this many samples is processed with
+ * processBlock() instead of process(), so that the expected vectors cover both
+ * code paths. Odd on purpose so that block boundaries move around relative to
+ * the stimuli.
+ */
+constexpr size_t TEST_BLOCK_SIZE = 61;
+
 template <typename signal_t>
 struct ComponentTestSet;
 
@@ -164,14 +174,22 @@ struct ComponentTest {
     if (!this->_stimulusIsActive(stimulus)) { return true; }
     this->owner.nTests++;
     auto x = this->_readInput(stimulus);
-    std::vector<Stereo<signal_t>> y;
+    std::vector<Stereo<signal_t>> y(x.size());
     this->cut.reset(NTFX_FS);
-    for (auto _x : x) { y.push_back(cut.process(_x)); }
+    for (size_t i = 0; i < x.size(); i += TEST_BLOCK_SIZE) {
+      auto n = std::min(TEST_BLOCK_SIZE, x.size() - i);
+      if ((i / TEST_BLOCK_SIZE) % 2) {
+        this->cut.processBlock(x.data() + i, y.data() + i, n);
+        continue;
+      }
+      for (size_t j = i; j < i + n; j++) { y[j] = this->cut.process(x[j]); }
+    }
     const auto yPath = "testWrapper/out/" + this->owner.name + SEPARATOR
-        + this->objName + SEPARATOR + stimulus + SEPARATOR + "result.txt";
-    std::ofstream yFile(yPath);
-    yFile << std::fixed << std::setprecision(16);
-    for (auto _y : y) { yFile << _y.l << " " << _y.r << "\n"; }
+        + this->objName + SEPARATOR + stimulus + SEPARATOR + "result"
+        + std::string(TestVector::binaryExt);
+    if (!TestVector::writeBinary(yPath, y)) {
+      std::cout << "Could not write '" << yPath << "'.\n";
+    }
     auto success = this->_compareExpected(stimulus, y);
     if (success) {
       std::cout << "\033[32m";
@@ -186,16 +204,12 @@ struct ComponentTest {
   }
 
   std::vector<Stereo<signal_t>> _readInput(std::string stimulus) {
-    auto xPath = "testWrapper/in/" + stimulus + ".txt";
-    if (!std::filesystem::exists(xPath)) {
-      std::cout << "Input file '" << xPath << "'not found. Aborting test."
-                << "\n";
+    std::vector<Stereo<signal_t>> x;
+    std::string error;
+    if (!TestVector::load("testWrapper/in/" + stimulus, x, error)) {
+      std::cout << "Input: " << error << " Aborting test.\n";
       return { };
     }
-    std::fstream xFile(xPath);
-    std::vector<Stereo<signal_t>> x;
-    signal_t l, r;
-    while (xFile >> l >> r) { x.push_back({ l, r }); }
     return x;
   }
 
@@ -210,26 +224,14 @@ struct ComponentTest {
 
   std::vector<Stereo<signal_t>> _readExpected(std::string stimulus) {
     auto expPath = "testWrapper/in/" + this->owner.name + SEPARATOR
-        + this->objName + SEPARATOR + stimulus + SEPARATOR + "expected.txt";
-    bool expFileExists = std::filesystem::exists(expPath);
-    if (!expFileExists) {
-      std::cout << "File with expected results not found at path '" + expPath
-              + "'. Skipping comparison."
+        + this->objName + SEPARATOR + stimulus + SEPARATOR + "expected";
+    std::vector<Stereo<signal_t>> e;
+    std::string error;
+    if (!TestVector::load(expPath, e, error)) {
+      std::cout << "Expected results: " << error << " Skipping comparison."
                 << "\n";
       return { };
     }
-    std::vector<Stereo<signal_t>> e;
-    std::fstream eFile(expPath);
-    std::string line;
-    while (std::getline(eFile, line)) {
-      std::istringstream iss(line);
-      float l, r;
-      if (iss >> l >> r) {
-        e.push_back({ l, r });
-      } else {
-        e.push_back({ 0, 0 });
-      }
-    }
     return e;
   }
 
@@ -243,8 +245,9 @@ struct ComponentTest {
     }
     signal_t acceptedDiff = 0.0001;
     for (size_t i = 0; i < y.size(); i++) {
-      auto diff = gcem::abs(y[i] - e[i]);
-      if (diff > acceptedDiff) {
+      // Per channel and negated, so that one channel off or a NaN fails.
+      auto diff = (y[i] - e[i]).abs();
+      if (!(diff.l <= acceptedDiff && diff.r <= acceptedDiff)) {
         std::cout << this->owner.name << "." << this->objName << "." << stimulus
                   << ":" << " output: {" << y[i].l << ", " << y[i].r
                   << "}, expected: {" << e[i].l << ", " << e[i].r
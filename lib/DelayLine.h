@@ -0,0 +1,185 @@
+#pragma once
+
+/**
+ * @file DelayLine.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Stereo delay line with fractional delay reads.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lib/Component.h"
+#include "lib/Stereo.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace NtFx {
+
+/**
+ * @brief How to read between samples.
+ */
+enum struct Interpolation {
+  none,     ///< Nearest sample.
+  linear,   ///< Cheap and fine for modulated delays.
+  lagrange, ///< Third order Lagrange. Flatter top end than linear.
+  allpass,  ///< First order allpass. Flat magnitude, for static delays.
+};
+
+/**
+ * @brief Stereo delay line. The buffer is allocated in reset() from
+ * 'maxDelay_s' and the sample rate, rounded up to a power of two so that wrap
+ * around is a mask. Call reset() before processing and not from the audio
+ * thread.
+ *
+ * process() writes a sample and reads 'delay' samples back with the selected
+ * interpolation. For more taps, call push() once per sample and read as often
+ * as needed. A delay of 0 returns the latest sample. Delays are clamped to
+ * the length of the buffer.
+ *
+ * @tparam signal_t Audio datatype.
+ */
+template <typename signal_t>
+struct DelayLine : public Component<Stereo<signal_t>> {
+  signal_t maxDelay_s { 1 };    ///< Longest delay needed. Used by reset().
+  Stereo<signal_t> delay { 0 }; ///< Delay used by process() in samples.
+  Interpolation interpolation { Interpolation::linear };
+  std::vector<Stereo<signal_t>> buffer;
+  size_t mask { 0 };
+  size_t iWrite { 0 };
+  Stereo<signal_t> apState { 0 }; ///< Last output of readAllpass().
+
+  virtual Stereo<signal_t> process(Stereo<signal_t> x) noexcept override {
+    this->push(x);
+    switch (this->interpolation) {
+    case Interpolation::none:
+      return this->readNearest(this->delay);
+    case Interpolation::linear:
+      return this->readLinear(this->delay);
+    case Interpolation::lagrange:
+      return this->readLagrange(this->delay);
+    case Interpolation::allpass:
+      return this->readAllpass(this->delay);
+    }
+    return x;
+  }
+
+  /**
+   * @brief Allocates and clears the buffer.
+   *
+   * @param fs Sample rate, including any oversampling.
+   */
+  virtual void reset(float fs) noexcept override {
+    this->fs      = fs;
+    size_t len    = size_t(std::ceil(this->maxDelay_s * fs)) + 4;
+    size_t lenPow = 1;
+    while (lenPow < len) { lenPow *= 2; }
+    this->buffer.assign(lenPow, Stereo<signal_t>(0));
+    this->mask    = lenPow - 1;
+    this->iWrite  = 0;
+    this->apState = 0;
+    this->update();
+  }
+
+  /**
+   * @brief Writes a sample.
+   *
+   * @param x Input.
+   */
+  void push(Stereo<signal_t> x) noexcept {
+    this->iWrite               = (this->iWrite + 1) & this->mask;
+    this->buffer[this->iWrite] = x;
+  }
+
+  /**
+   * @brief Longest delay that can be read in samples.
+   */
+  signal_t getMaxDelaySamples() const noexcept {
+    return this->buffer.size() < 4 ? 0 : signal_t(this->buffer.size() - 4);
+  }
+
+  Stereo<signal_t> readNearest(Stereo<signal_t> d) const noexcept {
+    return { this->_at(size_t(std::lround(this->_clamp(d.l)))).l,
+      this->_at(size_t(std::lround(this->_clamp(d.r)))).r };
+  }
+
+  Stereo<signal_t> readLinear(Stereo<signal_t> d) const noexcept {
+    return { this->template _linear<&Stereo<signal_t>::l>(d.l),
+      this->template _linear<&Stereo<signal_t>::r>(d.r) };
+  }
+
+  Stereo<signal_t> readLagrange(Stereo<signal_t> d) const noexcept {
+    return { this->template _lagrange<&Stereo<signal_t>::l>(d.l),
+      this->template _lagrange<&Stereo<signal_t>::r>(d.r) };
+  }
+
+  /**
+   * @brief Reads through a first order allpass. The allpass keeps state, so
+   * use it for one tap per delay line, and keep the delay still or slowly
+   * moving.
+   */
+  Stereo<signal_t> readAllpass(Stereo<signal_t> d) noexcept {
+    this->apState = {
+      this->template _allpass<&Stereo<signal_t>::l>(d.l, this->apState.l),
+      this->template _allpass<&Stereo<signal_t>::r>(d.r, this->apState.r),
+    };
+    return this->apState;
+  }
+
+  const Stereo<signal_t>& _at(size_t n) const noexcept {
+    return this->buffer[(this->iWrite - n) & this->mask];
+  }
+
+  signal_t _clamp(signal_t d) const noexcept {
+    return std::clamp(d, signal_t(0), this->getMaxDelaySamples());
+  }
+
+  template <signal_t Stereo<signal_t>::*ch>
+  signal_t _linear(signal_t d) const noexcept {
+    d              = this->_clamp(d);
+    const size_t n = size_t(d);
+    const auto a   = d - signal_t(n);
+    const auto x0  = this->_at(n).*ch;
+    return x0 + a * (this->_at(n + 1).*ch - x0);
+  }
+
+  template <signal_t Stereo<signal_t>::*ch>
+  signal_t _lagrange(signal_t d) const noexcept {
+    d = this->_clamp(d);
+    // Taps n - 1 to n + 2 around the delay, shifted up at the start.
+    const size_t n0 = d < 1 ? 0 : size_t(d) - 1;
+    const auto t    = d - signal_t(n0);
+    const auto t1   = t - 1;
+    const auto t2   = t - 2;
+    const auto t3   = t - 3;
+    return -t1 * t2 * t3 / 6 * (this->_at(n0).*ch)
+        + t * t2 * t3 / 2 * (this->_at(n0 + 1).*ch)
+        - t * t1 * t3 / 2 * (this->_at(n0 + 2).*ch)
+        + t * t1 * t2 / 6 * (this->_at(n0 + 3).*ch);
+  }
+
+  template <signal_t Stereo<signal_t>::*ch>
+  signal_t _allpass(signal_t d, signal_t y1) const noexcept {
+    // The fraction is kept in [0.5, 1.5) where the allpass is well behaved.
+    d              = std::max(this->_clamp(d), signal_t(0.5));
+    const size_t n = size_t(d - signal_t(0.5));
+    const auto a   = d - signal_t(n);
+    const auto eta = (1 - a) / (1 + a);
+    return eta * (this->_at(n).*ch) + this->_at(n + 1).*ch - eta * y1;
+  }
+};
+}
@@ -21,6 +21,7 @@
  */
 
 #include "lib/Component.h"
+#include "lib/Simd.h"
 #include "lib/Stereo.h"
 #include <math.h>
 
@@ -52,19 +53,17 @@ namespace FirstOrder {
     signal_t _xn1  = 0;
 
     virtual signal_t process(signal_t x) noexcept override {
-      signal_t y;
-      if constexpr (shape == Shape::none) {
-        return x;
-      } else if constexpr (shape == Shape::lpf) {
-        y = this->_a * x + (1 - this->_a) * _yn1;
-      } else if constexpr (shape == Shape::hpf) {
-        y = this->_a * (this->_yn1 + x - this->_xn1);
-      } else {
-        y = signal_t(0.5) * this->_a * (x + _xn1) + (1 - this->_a) * _yn1;
-      }
-      this->_xn1 = x;
-      this->_yn1 = y;
-      return y;
+      return _filter(this->_a, this->_xn1, this->_yn1, x);
+    }
+
+    virtual void processBlock(
+        const signal_t* x, signal_t* y, size_t n) noexcept override {
+      const auto a = this->_a;
+      auto xn1     = this->_xn1;
+      auto yn1     = this->_yn1;
+      for (size_t i = 0; i < n; i++) { y[i] = _filter(a, xn1, yn1, x[i]); }
+      this->_xn1 = xn1;
+      this->_yn1 = yn1;
     }
 
     virtual void update() noexcept override {
@@ -83,6 +82,33 @@ namespace FirstOrder {
       this->_yn1 = 0;
       this->update();
     }
+
+    /**
+     * @brief The filter difference equation. Static so that block processing
+     * can keep the state in local variables.
+     *
+     * @param a Filter coefficient.
+     * @param xn1 Previous input.
+     * @param yn1 Previous output.
+     * @param x Input.
+     * @return signal_t Output.
+     */
+    static inline signal_t _filter(
+        signal_t a, signal_t& xn1, signal_t& yn1, signal_t x) noexcept {
+      signal_t y;
+      if constexpr (shape == Shape::none) {
+        return x;
+      } else if constexpr (shape == Shape::lpf) {
+        y = a * x + (1 - a) * yn1;
+      } else if constexpr (shape == Shape::hpf) {
+        y = a * (yn1 + x - xn1);
+      } else {
+        y = signal_t(0.5) * a * (x + xn1) + (1 - a) * yn1;
+      }
+      xn1 = x;
+      yn1 = y;
+      return y;
+    }
   };
 
   /**
@@ -100,6 +126,44 @@ namespace FirstOrder {
       return { l.process(x.l), r.process(x.r) };
     }
 
+    virtual void processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept override {
+      if constexpr (shape == Shape::none) {
+        for (size_t i = 0; i < n; i++) { y[i] = x[i]; }
+        return;
+      } else {
+        // Same difference equations as Filter::_filter() with both channels
+        // in one register.
+        using vec_t  = Simd::StereoVec<signal_t>;
+        const auto a = vec_t::set(this->l._a, this->r._a);
+        const auto b = vec_t::splat(1) - a;
+        [[maybe_unused]] const auto aHalf = vec_t::splat(0.5) * a;
+        auto xn1 = vec_t::set(this->l._xn1, this->r._xn1);
+        auto yn1 = vec_t::set(this->l._yn1, this->r._yn1);
+        for (size_t i = 0; i < n; i++) {
+          const auto xn = vec_t::load(x + i);
+          vec_t yn;
+          if constexpr (shape == Shape::lpf) {
+            yn = a * xn + b * yn1;
+          } else if constexpr (shape == Shape::hpf) {
+            yn = a * (yn1 + xn - xn1);
+          } else {
+            yn = aHalf * (xn + xn1) + b * yn1;
+          }
+          xn1 = xn;
+          yn1 = yn;
+          yn.store(y + i);
+        }
+        const auto _xn1 = xn1.toStereo();
+        const auto _yn1 = yn1.toStereo();
+        this->l._xn1    = _xn1.l;
+        this->r._xn1    = _xn1.r;
+        this->l._yn1    = _yn1.l;
+        this->r._yn1    = _yn1.r;
+      }
+    }
+
     virtual void update() noexcept override {
       l.update();
       r.update();
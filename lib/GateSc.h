@@ -37,8 +37,14 @@ namespace Gate {
 
   enum State { open, hold, release, closed };
 
-  template <typename signal_t>
-  struct Sc : public Component<Stereo<signal_t>> {
+  /**
+   * @brief Gate side chain. Returns the gain to apply.
+   *
+   * @tparam signal_t Audio datatype.
+   * @tparam math_t dB conversions, ExactMath or FastMath.
+   */
+  template <typename signal_t, typename math_t = ExactMath>
+  struct Sc final : public Component<Stereo<signal_t>> {
     PeakSensor<signal_t> sensor;
     ScSettings<signal_t>& settings;
     State state;
@@ -57,6 +63,12 @@ namespace Gate {
       return { y, y };
     }
 
+    virtual void processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n) noexcept override {
+      for (size_t i = 0; i < n; i++) { y[i] = this->process(x[i]); }
+    }
+
     virtual void update() noexcept override {
       this->_alphaAtt = gcem::exp(-2200 / (this->settings.tAtt_ms * this->fs));
       this->_slopeRel = this->settings.range_db * signal_t(20)
@@ -78,7 +90,7 @@ namespace Gate {
 
     signal_t gateSc_db(signal_t x) {
       auto ySens { this->sensor.process(x) };
-      auto x_db = NtFx::db(ySens);
+      auto x_db = math_t::db(ySens);
       signal_t target_db { -1e-20 };
       if (x_db > this->settings.thresh_db) {
         this->state      = State::open;
@@ -102,7 +114,7 @@ namespace Gate {
       auto y_db = this->_alphaAtt * this->_stateAtt
           + (1 - this->_alphaAtt) * this->_stateRel;
       this->_stateAtt = y_db;
-      return NtFx::invDb(y_db);
+      return math_t::invDb(y_db);
     }
   };
 }
@@ -0,0 +1,211 @@
+#pragma once
+
+/**
+ * @file ParamRegistry.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Dense parameter IDs with constant time lookup by name.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace NtFx {
+
+constexpr int noParamId = -1; ///< Returned when a name is not registered.
+
+/**
+ * @brief Type of the value behind a parameter.
+ */
+enum struct ParamType {
+  knob,   ///< signal_t
+  toggle, ///< bool
+  option, ///< int, for drop downs and radio buttons.
+};
+
+/**
+ * @brief Spec vector of the plugin holding a parameter.
+ */
+enum struct ParamGroup {
+  primaryKnobs,
+  secondaryKnobs,
+  toggles,
+  dropdowns,
+  radioButtons,
+  toggleSets,
+};
+
+/**
+ * @brief Where to find a parameter. The spec is found by index rather than by
+ * pointer, so IDs stay valid when the spec vectors are copied or grow.
+ */
+struct ParamRef {
+  ParamType type;
+  ParamGroup group;
+  size_t idx;          ///< Index in the spec vector of the group.
+  size_t subIdx { 0 }; ///< Index of the toggle in a toggle set.
+};
+
+/**
+ * @brief Maps parameter names to dense IDs, 0 to size() - 1, with a perfect
+ * hash (hash and displace). Names are first hashed into buckets, and each
+ * bucket is given a seed that places all of its names in free slots of the
+ * table, so a lookup is two hashes and one string compare. The table is built
+ * once by build() and never allocates afterwards.
+ */
+struct ParamRegistry {
+  std::vector<std::string> names; ///< Name of each ID.
+  std::vector<ParamRef> refs;     ///< Location of each ID.
+  std::vector<uint32_t> seeds;    ///< Displacement seed per bucket.
+  std::vector<int> slots;         ///< ID per slot, or noParamId.
+
+  /**
+   * @brief Removes all parameters.
+   */
+  void clear() {
+    this->names.clear();
+    this->refs.clear();
+    this->seeds.clear();
+    this->slots.clear();
+  }
+
+  /**
+   * @brief Registers a parameter. Call build() when all are added.
+   *
+   * @param name Name of the parameter.
+   * @param ref Location of the parameter.
+   * @return int ID of the parameter.
+   */
+  int add(std::string name, ParamRef ref) {
+    this->names.push_back(std::move(name));
+    this->refs.push_back(ref);
+    return int(this->names.size() - 1);
+  }
+
+  /**
+   * @brief Number of registered parameters.
+   */
+  size_t size() const noexcept { return this->names.size(); }
+
+  /**
+   * @brief Builds the lookup table. If a name is registered twice, lookups
+   * find the first one.
+   */
+  void build() {
+    const size_t n        = this->names.size();
+    const size_t nBuckets = _pow2(std::max(n / 2, size_t(1)));
+    size_t nSlots         = _pow2(std::max(2 * n, size_t(1)));
+    std::vector<std::vector<int>> buckets(nBuckets);
+    for (size_t id = 0; id < n; id++) {
+      auto& b     = buckets[_hash(0, this->names[id]) & (nBuckets - 1)];
+      bool isDupe = false;
+      for (int other : b) {
+        if (this->names[other] == this->names[id]) { isDupe = true; }
+      }
+      if (!isDupe) { b.push_back(int(id)); }
+    }
+    std::vector<size_t> order(nBuckets);
+    for (size_t i = 0; i < nBuckets; i++) { order[i] = i; }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return buckets[a].size() > buckets[b].size();
+    });
+    std::vector<size_t> placed;
+    while (true) {
+      this->seeds.assign(nBuckets, 0);
+      this->slots.assign(nSlots, noParamId);
+      bool ok = true;
+      for (size_t iBucket : order) {
+        if (!this->_place(buckets[iBucket], iBucket, nSlots, placed)) {
+          ok = false;
+          break;
+        }
+      }
+      if (ok) { return; }
+      nSlots *= 2;
+    }
+  }
+
+  /**
+   * @brief Looks up a parameter by name.
+   *
+   * @param name Name of the parameter.
+   * @return int ID of the parameter, or noParamId if not registered.
+   */
+  int find(std::string_view name) const noexcept {
+    if (this->slots.empty()) { return noParamId; }
+    const uint32_t seed
+        = this->seeds[_hash(0, name) & (this->seeds.size() - 1)];
+    const int id = this->slots[_hash(seed, name) & (this->slots.size() - 1)];
+    if (id == noParamId || this->names[id] != name) { return noParamId; }
+    return id;
+  }
+
+  bool _place(const std::vector<int>& bucket,
+      size_t iBucket,
+      size_t nSlots,
+      std::vector<size_t>& placed) {
+    constexpr uint32_t nSeedsMax = 1 << 16;
+    for (uint32_t seed = 1; seed < nSeedsMax; seed++) {
+      placed.clear();
+      for (int id : bucket) {
+        size_t slot = _hash(seed, this->names[id]) & (nSlots - 1);
+        if (this->slots[slot] != noParamId
+            || std::find(placed.begin(), placed.end(), slot) != placed.end()) {
+          break;
+        }
+        placed.push_back(slot);
+      }
+      if (placed.size() < bucket.size()) { continue; }
+      for (size_t i = 0; i < bucket.size(); i++) {
+        this->slots[placed[i]] = bucket[i];
+      }
+      this->seeds[iBucket] = seed;
+      return true;
+    }
+    return false;
+  }
+
+  static size_t _pow2(size_t n) noexcept {
+    size_t p = 1;
+    while (p < n) { p *= 2; }
+    return p;
+  }
+
+  /**
+   * @brief Seeded FNV-1a with a final avalanche, so every seed gives an
+   * independent placement.
+   */
+  static uint32_t _hash(uint32_t seed, std::string_view s) noexcept {
+    uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+    for (unsigned char c : s) {
+      h ^= c;
+      h *= 16777619u;
+    }
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+  }
+};
+}
@@ -24,9 +24,10 @@
 
 #include "gcem.hpp"
 #include "lib/Component.h"
+#include "lib/SlidingMax.h"
 #include "lib/Stereo.h"
 #include "lib/utils.h"
-#include <array>
+#include <algorithm>
 #include <cstddef>
 
 namespace NtFx {
@@ -62,6 +63,22 @@ struct PeakSensor : public Component<signal_t> {
     return this->_peakSensor(this->_alpha, this->_state, x);
   }
 
+  /**
+   * @brief Processes a block of samples keeping the sensor state in a local
+   * variable.
+   *
+   * @param x Input samples.
+   * @param y Detected peak amplitude.
+   * @param n Number of samples.
+   */
+  virtual void processBlock(
+      const signal_t* x, signal_t* y, size_t n) noexcept override {
+    const auto alpha = this->_alpha;
+    auto state       = this->_state;
+    for (size_t i = 0; i < n; i++) { y[i] = _peakSensor(alpha, state, x[i]); }
+    this->_state = state;
+  }
+
   /**
    * @brief Updates the internal parameters of the peak sensor.
    *
@@ -128,25 +145,20 @@ struct PeakSensorStereo
   }
 };
 
-constexpr int defaultPeakSensorDelayLineLength = 192 * 10 * 8;
-
 /**
- * @brief Peak sensor with hold. Output will remain at the max value for
- * tHold_ms miliseconds when after peak and the curve will be delayed by the
- * same amount time when going down.
+ * @brief Peak sensor with hold. The output is the maximum of the peak sensor
+ * output over the last tHold_ms, so it holds a peak for tHold_ms and follows
+ * the sensor curve delayed by tHold_ms when going down. The window is a
+ * SlidingMax allocated in reset() from the longer of 'tHold_ms' and
+ * 'maxTHold_ms'. Longer holds set later are limited to that.
  *
  * @tparam signal_t Audio signal type.
- * @tparam delayLineLength Maximum delay time.
  */
-template <typename signal_t,
-    int delayLineLength = defaultPeakSensorDelayLineLength>
+template <typename signal_t>
 struct PeakHoldSensor : public PeakSensor<signal_t> {
-  std::array<signal_t, delayLineLength> _dl;
+  SlidingMax<signal_t> hold;
   signal_t tHold_ms { 10 };
-  signal_t _xMax { 0 };
-  int _idx { 0 };
-  int _nHold { 0 };
-  int _holdCnt { 0 };
+  signal_t maxTHold_ms { 0 }; ///< Longest hold without a new reset().
 
   /**
    * @brief Processes signal with peak sensor with hold.
@@ -155,21 +167,22 @@ struct PeakHoldSensor : public PeakSensor<signal_t> {
    * @return signal_t Sensor output.
    */
   virtual signal_t process(signal_t x) noexcept override {
-    auto _x = this->_peakSensor(this->_alpha, this->_state, x);
-
-    this->_dl[this->_idx++] = _x;
-    if (this->_idx >= delayLineLength) { this->_idx = 0; }
-    if (_x >= this->_xMax) {
-      this->_holdCnt = 0;
-      this->_xMax    = _x;
-    } else if (this->_holdCnt < this->_nHold) {
-      this->_holdCnt++;
-    } else {
-      auto readIdx = this->_idx - _nHold - 1;
-      if (readIdx < 0) { readIdx += delayLineLength; }
-      this->_xMax = this->_dl[readIdx];
-    }
-    return this->_xMax;
+    return this->hold.process(
+        this->_peakSensor(this->_alpha, this->_state, x));
+  }
+
+  /**
+   * @brief Processes a block of samples. Overridden since the block version of
+   * PeakSensor bypasses the hold.
+   *
+   * @param x Input samples.
+   * @param y Sensor output.
+   * @param n Number of samples.
+   */
+  virtual void processBlock(
+      const signal_t* x, signal_t* y, size_t n) noexcept override {
+    this->PeakSensor<signal_t>::processBlock(x, y, n);
+    this->hold.processBlock(y, y, n);
   }
 
   /**
@@ -177,17 +190,21 @@ struct PeakHoldSensor : public PeakSensor<signal_t> {
    *
    */
   virtual void update() noexcept override {
-    this->_nHold = this->tHold_ms * this->fs / 1000;
-    this->_nHold =
-        (this->_nHold >= delayLineLength ? delayLineLength - 1 : this->_nHold);
+    this->hold.t_ms = this->tHold_ms;
+    this->hold.update();
     this->PeakSensor<signal_t>::update();
   }
+
+  virtual void reset(float fs) noexcept override {
+    this->hold.maxT_ms = std::max(this->tHold_ms, this->maxTHold_ms);
+    this->hold.reset(fs);
+    this->PeakSensor<signal_t>::reset(fs);
+  }
 };
 
-template <typename signal_t,
-    int delayLineLength = defaultPeakSensorDelayLineLength>
-struct PeakHoldSensorStereo : public StereoComponent<signal_t,
-                                  PeakHoldSensor<signal_t, delayLineLength>> {
+template <typename signal_t>
+struct PeakHoldSensorStereo
+    : public StereoComponent<signal_t, PeakHoldSensor<signal_t>> {
   /**
    * @brief Sets the time constant for peak detection in milliseconds.
    *
@@ -0,0 +1,100 @@
+#pragma once
+
+/**
+ * @file PlanarBlock.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Block of planar stereo audio.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lib/Component.h"
+#include "lib/Simd.h"
+#include "lib/Stereo.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace NtFx {
+
+/**
+ * @brief Planar stereo block, as delivered by most hosts, that components can
+ * be run over with a single call. The channels are owned by the caller. The
+ * block interleaves chunks of the channels into a work buffer of frames, which
+ * is the layout processBlock() and StereoVec use, and writes the result back.
+ *
+ * @tparam signal_t Audio datatype.
+ */
+template <typename signal_t>
+struct PlanarBlock {
+  signal_t* l { nullptr }; ///< Left channel.
+  signal_t* r { nullptr }; ///< Right channel.
+  size_t n { 0 };          ///< Number of samples in the block.
+  std::vector<Stereo<signal_t>> frames; ///< Interleaved work buffer.
+
+  /**
+   * @brief Allocates the work buffer. Call this outside the audio thread.
+   * Blocks longer than the work buffer are processed in chunks.
+   *
+   * @param nMax Length of the work buffer.
+   */
+  void reserve(size_t nMax) { this->frames.resize(nMax); }
+
+  /**
+   * @brief Points the block at a pair of channels.
+   *
+   * @param l Left channel.
+   * @param r Right channel.
+   * @param n Number of samples.
+   */
+  void set(signal_t* l, signal_t* r, size_t n) noexcept {
+    this->l = l;
+    this->r = r;
+    this->n = n;
+  }
+
+  /**
+   * @brief Runs a function over the block in place, one chunk of interleaved
+   * frames at a time.
+   *
+   * @param process Called as process(frames, i0, m) for each chunk of 'm'
+   * frames starting at sample 'i0' of the block. Writes its output to
+   * 'frames'.
+   */
+  template <typename process_t>
+  void forEachChunk(process_t&& process) noexcept {
+    const size_t nFrames = this->frames.size();
+    for (size_t i0 = 0; nFrames && i0 < this->n; i0 += nFrames) {
+      const size_t m = std::min(nFrames, this->n - i0);
+      auto p_frames  = this->frames.data();
+      Simd::interleave(this->l + i0, this->r + i0, p_frames, m);
+      process(p_frames, i0, m);
+      Simd::deinterleave(p_frames, this->l + i0, this->r + i0, m);
+    }
+  }
+
+  /**
+   * @brief Processes the block in place with a stereo component.
+   *
+   * @param c Component to process with.
+   */
+  void process(Component<Stereo<signal_t>>& c) noexcept {
+    this->forEachChunk([&c](Stereo<signal_t>* p_frames, size_t, size_t m) {
+      c.processBlock(p_frames, p_frames, m);
+    });
+  }
+};
+}
@@ -22,19 +22,50 @@
  */
 
 #include "lib/Component.h"
+#include "lib/ParamRegistry.h"
+#include "lib/Profiler.h"
 #include "lib/RmsSensor.h"
+#include "lib/Simd.h"
+#include "lib/SpscQueue.h"
 #include "lib/Stereo.h"
 #include "lib/UiSpec.h"
 #include "lib/utils.h"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
 namespace NtFx {
 
+/**
+ * @brief Capacity of the meter queue of a plugin. Holds about 85 ms of blocks
+ * of 32 samples at 48 kHz, several refreshes of the UI.
+ */
+constexpr size_t nMeterSnapshotsMax = 128;
+
+/**
+ * @brief Frames of meter taps buffered by processBlock() before they are
+ * reduced to peak levels.
+ */
+constexpr size_t nMeterTapFrames = 64;
+
+/**
+ * @brief Meter levels sent from the audio thread to the UI, one per block.
+ *
+ * @tparam signal_t Basic datatype for audio signal.
+ */
+template <typename signal_t>
+struct MeterSnapshot {
+  int64_t samplePos { 0 }; ///< Timeline position at the end of the block.
+  std::array<Stereo<signal_t>, nMetersMax> peak; ///< Peak level per meter.
+  std::array<Stereo<signal_t>, 2> rms;           ///< RMS of input and output.
+};
+
 /**
  * @brief True virtual base class for NtPlugin. Inherit from this in order to
  * make a stereo audio plugin with auto-genrated UI.
@@ -48,13 +79,31 @@ struct NtPlugin : public Component<Stereo<signal_t>> {
    * @brief Array of rms sensors for RMS meter.
    *
    */
-  std::array<RmsSensorStereo<signal_t, 250, 192>, 2> xRms;
+  std::array<RmsSensorStereo<signal_t>, 2> xRms {
+    RmsSensorStereo<signal_t>(250),
+    RmsSensorStereo<signal_t>(250),
+  };
 
   /**
-   * @brief Peak level to be displayed in the meters.
+   * @brief Peak level of each meter since the last call to publishMeters().
+   * Audio thread only.
    */
   std::array<Stereo<signal_t>, nMetersMax> peakLevels;
 
+  /**
+   * @brief Values passed to tap() during the current chunk of processBlock(),
+   * per meter. Frames not tapped hold peakDefault(). Audio thread only.
+   */
+  std::array<std::array<Stereo<signal_t>, nMeterTapFrames>, nMetersMax>
+      tapFrames;
+  size_t iTapFrame { 0 };     ///< Frame of 'tapFrames' written by tap().
+  bool tapBuffered { false }; ///< True while processBlock() buffers taps.
+
+  /**
+   * @brief Meter levels on their way from the audio thread to the UI.
+   */
+  SpscQueue<MeterSnapshot<signal_t>, nMeterSnapshotsMax> meterSnapshots;
+
   /**
    * @brief Specification for UI. Modify this to change the look of your
    * plugin.
@@ -97,8 +146,13 @@ struct NtPlugin : public Component<Stereo<signal_t>> {
    * @brief List of all meters to be displayed in the UI.
    */
   std::vector<MeterSpec> meters = {
-    { .name = "IN", .addRms = true },
-    { .name = "OUT", .hasScale = true, .addRms = true },
+    { .name = "IN", .addRms = true, .source = MeterSource::input },
+    {
+        .name     = "OUT",
+        .hasScale = true,
+        .addRms   = true,
+        .source   = MeterSource::output,
+    },
   };
 
   /**
@@ -113,9 +167,74 @@ struct NtPlugin : public Component<Stereo<signal_t>> {
   signal_t xSc;
 
   /**
-   * @brief Set this to true if you want to force an update of the UI
+   * @brief Side chain samples for the block currently being processed by
+   * processBlock(), at the rate the plugin runs at. Set by the wrapper and
+   * nullptr when no side chain is connected. The default processBlock() copies
+   * each sample to 'xSc' before calling process().
+   */
+  const signal_t* xScBlock { nullptr };
+
+  /**
+   * @brief Set this to true if you want to force an update of the UI. May be
+   * set on the audio thread. The UI clears it with exchange(false) before it
+   * reads the knob specs, so changes to 'isActive' made before setting it are
+   * seen.
+   */
+  UiFlag uiNeedsUpdate { false };
+
+  /**
+   * @brief Dense IDs of all parameters. Built by updateDefaults().
    */
-  bool uiNeedsUpdate = false;
+  ParamRegistry paramRegistry;
+
+  /**
+   * @brief Value of each parameter by ID. Cast according to the type in
+   * 'paramRegistry.refs'.
+   */
+  std::vector<void*> paramVals;
+
+#ifdef NTFX_PROFILE
+  /**
+   * @brief CPU time per stage marked with NTFX_PROFILE_SCOPE(this->profile,
+   * ...). Only exists in builds with NTFX_PROFILE defined.
+   */
+  Profile::Table profile;
+#endif
+
+  /**
+   * @brief Processes a block of samples. Calls process() for every sample and
+   * keeps 'xSc' updated from 'xScBlock'. Values passed to tap() are buffered
+   * and reduced to peak levels once per nMeterTapFrames samples. Override this
+   * if your plugin can process whole blocks, but remember to handle the side
+   * chain and to call tap() outside of this function or with 'tapBuffered'
+   * false.
+   *
+   * @param x Input samples.
+   * @param y Output samples. May be the same buffer as 'x'.
+   * @param n Number of samples.
+   */
+  virtual void processBlock(const Stereo<signal_t>* x,
+      Stereo<signal_t>* y,
+      size_t n) noexcept override {
+    this->tapBuffered = true;
+    for (size_t i0 = 0; i0 < n; i0 += nMeterTapFrames) {
+      const size_t m = std::min(nMeterTapFrames, n - i0);
+      if (!this->xScBlock) {
+        for (size_t i = 0; i < m; i++) {
+          this->iTapFrame = i;
+          y[i0 + i]       = this->process(x[i0 + i]);
+        }
+      } else {
+        for (size_t i = 0; i < m; i++) {
+          this->iTapFrame = i;
+          this->xSc       = this->xScBlock[i0 + i];
+          y[i0 + i]       = this->process(x[i0 + i]);
+        }
+      }
+      this->_reduceTaps(m);
+    }
+    this->tapBuffered = false;
+  }
 
   /**
    * @brief Called by the wrapper whenever the tempo changes.
@@ -123,20 +242,90 @@ struct NtPlugin : public Component<Stereo<signal_t>> {
    */
   virtual void onTempoChanged() noexcept { }
 
+  /**
+   * @brief Latency of the plugin in samples at the rate it runs at, e.g. from
+   * lookahead. The wrapper adds the latency of the sample rate converter and
+   * reports the sum to the host. Any dry signal mixed in by the plugin must be
+   * delayed by the same amount by the plugin itself.
+   *
+   * @return float Latency in samples.
+   */
+  virtual float getLatencySamples() const noexcept { return 0; }
+
+  /**
+   * @brief How long the plugin keeps producing output after the input has gone
+   * silent, e.g. for echoes or reverb tails. Reported to the host.
+   *
+   * @return float Tail length in seconds.
+   */
+  virtual float getTailSeconds() const noexcept { return 0; }
+
+  /**
+   * @brief Looks up the ID of a parameter. Toggles in toggle sets are named
+   * as returned by makeTmpToggle(set, toggle, "toggleGroup").
+   *
+   * @param name Name of the parameter.
+   * @return int ID of the parameter, or noParamId if not found.
+   */
+  int getParamId(std::string_view name) const noexcept {
+    return this->paramRegistry.find(name);
+  }
+
+  /**
+   * @brief Gets a pointer to the value of a knob.
+   *
+   * @param id ID of the knob.
+   * @return signal_t* The value, or nullptr if 'id' is not a knob.
+   */
+  signal_t* getKnobValuePtr(int id) const noexcept {
+    if (!this->_isParamType(id, ParamType::knob)) { return nullptr; }
+    return static_cast<signal_t*>(this->paramVals[id]);
+  }
+
+  /**
+   * @brief Gets the spec of a knob.
+   *
+   * @param id ID of the knob.
+   * @return KnobSpec<signal_t>* The spec, or nullptr if 'id' is not a knob.
+   */
+  KnobSpec<signal_t>* getKnobSpec(int id) noexcept {
+    if (!this->_isParamType(id, ParamType::knob)) { return nullptr; }
+    const auto& ref = this->paramRegistry.refs[id];
+    return ref.group == ParamGroup::primaryKnobs
+        ? &this->primaryKnobs[ref.idx]
+        : &this->secondaryKnobs[ref.idx];
+  }
+
+  /**
+   * @brief Gets a pointer to the value of a toggle.
+   *
+   * @param id ID of the toggle.
+   * @return bool* The value, or nullptr if 'id' is not a toggle.
+   */
+  bool* getToggleValuePtr(int id) const noexcept {
+    if (!this->_isParamType(id, ParamType::toggle)) { return nullptr; }
+    return static_cast<bool*>(this->paramVals[id]);
+  }
+
+  /**
+   * @brief Gets a pointer to the value of a drop down or radio button set.
+   *
+   * @param id ID of the drop down or radio button set.
+   * @return int* The value, or nullptr if 'id' is not an option.
+   */
+  int* getOptionValuePtr(int id) const noexcept {
+    if (!this->_isParamType(id, ParamType::option)) { return nullptr; }
+    return static_cast<int*>(this->paramVals[id]);
+  }
+
   /**
    * @brief Used by the wrapper to get a pointer to a value based on the
    * corresponding knob's name.
    *
    * @param name Name of knob to get value for.
    */
-  signal_t* getKnobValuePtr(std::string name) const noexcept {
-    for (auto param : this->primaryKnobs) {
-      if (param.name == name) { return param.p_val; }
-    }
-    for (auto param : this->secondaryKnobs) {
-      if (param.name == name) { return param.p_val; }
-    }
-    return nullptr;
+  signal_t* getKnobValuePtr(std::string_view name) const noexcept {
+    return this->getKnobValuePtr(this->getParamId(name));
   }
 
   /**
@@ -145,11 +334,8 @@ struct NtPlugin : public Component<Stereo<signal_t>> {
    *
    * @param name Name of toggle to get value for.
    */
-  bool* getToggleValuePtr(std::string name) const noexcept {
-    for (auto param : this->toggles) {
-      if (param.name == name) { return param.p_val; }
-    }
-    return nullptr;
+  bool* getToggleValuePtr(std::string_view name) const noexcept {
+    return this->getToggleValuePtr(this->getParamId(name));
   }
 
   /**
@@ -158,74 +344,54 @@ struct NtPlugin : public Component<Stereo<signal_t>> {
    *
    * @param name Name of drop down to get value for.
    */
-  int* getDropDownValuePtr(std::string name) const noexcept {
-    for (auto dropdown : this->dropdowns) {
-      if (dropdown.name == name) { return dropdown.p_val; }
-    }
-    return nullptr;
+  int* getDropDownValuePtr(std::string_view name) const noexcept {
+    return this->getOptionValuePtr(this->getParamId(name));
   }
 
-  void setParameterActive(std::string name, bool val) {
-    for (auto& param : this->primaryKnobs) {
-      if (param.name == name) {
-        param.isActive      = false;
-        this->uiNeedsUpdate = true;
-        return;
-      }
-    }
-    for (auto& param : this->secondaryKnobs) {
-      if (param.name == name) {
-        param.isActive      = false;
-        this->uiNeedsUpdate = true;
-        return;
-      }
-    }
+  /**
+   * @brief Grays out a parameter in the UI, or brings it back. Look the ID up
+   * once with getParamId() if this is called from update().
+   *
+   * @param id ID of the parameter.
+   * @param val true to activate, false to deactivate.
+   */
+  void setParameterActive(int id, bool val) noexcept {
+    auto* p_knob = this->getKnobSpec(id);
     // TODO: isActive field for all param types. INCLUDES fixing editor.
-    // for (auto& param : this->toggles) {
-    //   if (param.name == name) {
-    //     param.isActive      = false;
-    //     this->uiNeedsUpdate = true;
-    //     return;
-    //   }
-    // }
-    // for (auto& param : this->dropdowns) {
-    //   if (param.name == name) {
-    //     param.isActive      = false;
-    //     this->uiNeedsUpdate = true;
-    //     return;
-    //   }
-    // }
-    // for (auto& param : this->radioButtons) {
-    //   if (param.name == name) {
-    //     param.isActive      = false;
-    //     this->uiNeedsUpdate = true;
-    //     return;
-    //   }
-    // }
-    // for (auto& param : this->toggleSets) {
-    //   if (param.name == name) {
-    //     param.isActive      = false;
-    //     this->uiNeedsUpdate = true;
-    //     return;
-    //   }
-    // }
+    if (!p_knob) { return; }
+    if (p_knob->isActive == val) { return; }
+    p_knob->isActive    = val;
+    this->uiNeedsUpdate = true;
+  }
+
+  void setParameterActive(std::string_view name, bool val) noexcept {
+    this->setParameterActive(this->getParamId(name), val);
+  }
+
+  void deactivateParameter(int id) noexcept {
+    this->setParameterActive(id, false);
+  }
+
+  void activateParameter(int id) noexcept {
+    this->setParameterActive(id, true);
   }
 
-  void deactivateParameter(std::string name) {
+  void deactivateParameter(std::string_view name) noexcept {
     this->setParameterActive(name, false);
   }
 
-  void activateParameter(std::string name) {
+  void activateParameter(std::string_view name) noexcept {
     this->setParameterActive(name, true);
   }
 
   /**
    * @brief Copies the values of all members in the derived plugin class to
    * their respective knobs and toggels. Should always be called as the last
-   * thing in the constructor of the derived plugin class.
+   * thing in the constructor of the derived plugin class. Also assigns the
+   * parameter IDs.
    *
    */
-  constexpr void updateDefaults() noexcept {
+  void updateDefaults() {
     for (auto& k : this->primaryKnobs) {
       if (k.p_val) { k._defaultVal = *k.p_val; }
       if (k.logScale) { k.setLogScale(); }
@@ -248,57 +414,189 @@ struct NtPlugin : public Component<Stereo<signal_t>> {
         if (t.p_val) { t._defaultVal = *t.p_val; }
       }
     }
+    this->_registerParams();
+    this->_resetMeters();
+  }
+
+  void _resetMeters() noexcept {
+    for (size_t i = 0; i < nMetersMax; i++) {
+      this->peakLevels[i] = this->peakDefault(i);
+      this->tapFrames[i].fill(this->peakDefault(i));
+    }
+  }
+
+  void _registerParams() {
+    this->paramRegistry.clear();
+    this->paramVals.clear();
+    auto add = [&](std::string name, void* p_val, ParamRef ref) {
+      this->paramRegistry.add(std::move(name), ref);
+      this->paramVals.push_back(p_val);
+    };
+    for (size_t i = 0; i < this->primaryKnobs.size(); i++) {
+      auto& k = this->primaryKnobs[i];
+      add(k.name, k.p_val, { ParamType::knob, ParamGroup::primaryKnobs, i });
+    }
+    for (size_t i = 0; i < this->secondaryKnobs.size(); i++) {
+      auto& k = this->secondaryKnobs[i];
+      add(k.name, k.p_val, { ParamType::knob, ParamGroup::secondaryKnobs, i });
+    }
+    for (size_t i = 0; i < this->toggles.size(); i++) {
+      auto& t = this->toggles[i];
+      add(t.name, t.p_val, { ParamType::toggle, ParamGroup::toggles, i });
+    }
+    for (size_t i = 0; i < this->dropdowns.size(); i++) {
+      auto& d = this->dropdowns[i];
+      add(d.name, d.p_val, { ParamType::option, ParamGroup::dropdowns, i });
+    }
+    for (size_t i = 0; i < this->radioButtons.size(); i++) {
+      auto& r = this->radioButtons[i];
+      add(r.name, r.p_val, { ParamType::option, ParamGroup::radioButtons, i });
+    }
+    for (size_t i = 0; i < this->toggleSets.size(); i++) {
+      auto& s = this->toggleSets[i];
+      for (size_t j = 0; j < s.toggles.size(); j++) {
+        add(makeTmpToggle(s.name, s.toggles[j].name, "toggleGroup").name,
+            s.toggles[j].p_val,
+            { ParamType::toggle, ParamGroup::toggleSets, i, j });
+      }
+    }
+    this->paramRegistry.build();
+  }
+
+  bool _isParamType(int id, ParamType type) const noexcept {
+    return id >= 0 && size_t(id) < this->paramRegistry.size()
+        && this->paramRegistry.refs[id].type == type;
   }
 
   /**
-   * @brief Updates the peak level of a meter. This is a template so that we can
-   * do range checking at compile time.
+   * @brief Feeds a value to a meter with source MeterSource::plugin, e.g. the
+   * gain reduction of a compressor. The magnitude is kept per channel, the
+   * largest or for inverted meters the smallest. Inside processBlock() the
+   * value is only stored, and the peak is found for a whole chunk of samples
+   * at a time. This is a template so that the index is checked at compile
+   * time.
    *
-   * @tparam idx Index of meter to update.
-   * @tparam invert If true, the smallest value will be selected.
-   * @param val New value. If val has a larger magnitude than the current peak
-   value, the current peak value will be overridden.
-   * @return
+   * @tparam idx Index of meter.
+   * @param val Value to meter.
+   * @return Stereo<signal_t> val, unchanged.
+   */
+  template <size_t idx>
+  Stereo<signal_t> tap(Stereo<signal_t> val) noexcept {
+    static_assert(idx < nMetersMax, "Meter index is out of bounds.");
+    if (this->tapBuffered) {
+      this->tapFrames[idx][this->iTapFrame] = val;
+    } else {
+      this->_reducePeak(idx, &val, 1, this->peakLevels[idx]);
+    }
+    return val;
+  }
+
+  /**
+   * @brief Same as tap(). Kept for plugins written before meters had a
+   * source. Whether the meter is inverted is now read from its spec.
    */
   template <size_t idx, bool invert = false>
-  NtFx::Stereo<signal_t> updatePeakLevel(NtFx::Stereo<signal_t> val) noexcept {
-    if constexpr (idx >= nMetersMax) {
-      static_assert(false, "Meter index is out of bounds.");
+  Stereo<signal_t> updatePeakLevel(Stereo<signal_t> val) noexcept {
+    return this->template tap<idx>(val);
+  }
+
+  /**
+   * @brief Measures a block of the plugin input or output. Updates the peak
+   * level of every meter with the given source. Called by the wrapper.
+   *
+   * @param source MeterSource::input or MeterSource::output.
+   * @param x Frames.
+   * @param n Number of frames.
+   */
+  void meterBlock(
+      MeterSource source, const Stereo<signal_t>* x, size_t n) noexcept {
+    const size_t nMeters = std::min(this->meters.size(), size_t(nMetersMax));
+    for (size_t i = 0; i < nMeters; i++) {
+      if (this->meters[i].source != source) { continue; }
+      this->_reducePeak(i, x, n, this->peakLevels[i]);
     }
-    if (invert) {
-      if (val < this->peakLevels[idx]) { this->peakLevels[idx] = val; }
+  }
+
+  void _reducePeak(size_t idx,
+      const Stereo<signal_t>* x,
+      size_t n,
+      Stereo<signal_t>& peak) const noexcept {
+    if (idx < this->meters.size() && this->meters[idx].invert) {
+      peak = Simd::reducePeak<true>(x, n, peak);
     } else {
-      if (val > this->peakLevels[idx]) { this->peakLevels[idx] = val; }
+      peak = Simd::reducePeak<false>(x, n, peak);
     }
-    return val;
   }
 
   /**
-   * @brief Get and reset peak level for specified meter.
+   * @brief Folds the first m buffered taps of every plugin meter into its
+   * peak level and clears them.
+   */
+  void _reduceTaps(size_t m) noexcept {
+    const size_t nMeters = std::min(this->meters.size(), size_t(nMetersMax));
+    for (size_t i = 0; i < nMeters; i++) {
+      if (this->meters[i].source != MeterSource::plugin) { continue; }
+      auto& frames = this->tapFrames[i];
+      this->_reducePeak(i, frames.data(), m, this->peakLevels[i]);
+      std::fill_n(frames.begin(), m, Stereo<signal_t>(this->peakDefault(i)));
+    }
+  }
+
+  /**
+   * @brief Level of a meter with no signal. Inverted meters, like gain
+   * reduction, rest at 1.
+   *
+   * @param idx Index of meter.
+   */
+  signal_t peakDefault(size_t idx) const noexcept {
+    if (idx < this->meters.size() && this->meters[idx].invert) {
+      return signal_t(1);
+    }
+    return signal_t(0);
+  }
+
+  /**
+   * @brief Sends the meter levels of the block just processed to the UI and
+   * resets the peaks. Called by the wrapper on the audio thread once per
+   * block, so the queue costs a single atomic store per block. If the UI has
+   * fallen behind and the queue is full, the peaks are kept and go out with
+   * the next block instead.
    *
-   * @param idx
-   * @return NtFx::Stereo<signal_t> Highest signal level since last call.
-   */
-  NtFx::Stereo<signal_t> getAndResetPeakLevel(size_t idx) noexcept {
-    signal_t def = signal_t(0);
-    if (idx >= this->meters.size()) { return def; }
-    if (this->meters[idx].invert) { def = signal_t(1); }
-    ensureFinite(this->peakLevels[idx]);
-    NtFx::Stereo<signal_t> tmp = this->peakLevels[idx];
-    this->peakLevels[idx]      = signal_t(def);
-    return tmp;
+   * @param samplePos Timeline position at the end of the block.
+   */
+  void publishMeters(int64_t samplePos) noexcept {
+    MeterSnapshot<signal_t> snapshot;
+    snapshot.samplePos = samplePos;
+    for (size_t i = 0; i < nMetersMax; i++) {
+      ensureFinite(this->peakLevels[i]);
+      snapshot.peak[i] = this->peakLevels[i];
+    }
+    snapshot.rms = { this->xRms[0].getRms(), this->xRms[1].getRms() };
+    if (!this->meterSnapshots.push(snapshot)) { return; }
+    for (size_t i = 0; i < nMetersMax; i++) {
+      this->peakLevels[i] = this->peakDefault(i);
+    }
   }
 
   /**
-   * @brief Get the RMS level of meter with index idx. RMS level is calculated
-   * from the peak level.
+   * @brief Takes all meter levels published since the last call and merges
+   * them into one: the highest peak of each meter, or the lowest for inverted
+   * meters, and the newest RMS levels. UI thread only.
    *
-   * @param idx Index of meter to get RMS level for.
-   * @return NtFx::Stereo<signal_t> RMS level.
+   * @param snapshot Merged levels. Unchanged if nothing was published.
+   * @return true if anything was published since the last call.
    */
-  NtFx::Stereo<signal_t> getRms(size_t idx) noexcept {
-    if (idx >= 2) { return signal_t(0); }
-    return this->xRms[idx].getRms();
+  bool readMeters(MeterSnapshot<signal_t>& snapshot) noexcept {
+    MeterSnapshot<signal_t> next;
+    if (!this->meterSnapshots.pop(snapshot)) { return false; }
+    while (this->meterSnapshots.pop(next)) {
+      for (size_t i = 0; i < nMetersMax; i++) {
+        this->_reducePeak(i, &next.peak[i], 1, snapshot.peak[i]);
+      }
+      snapshot.samplePos = next.samplePos;
+      snapshot.rms       = next.rms;
+    }
+    return true;
   }
 };
 }
\ No newline at end of file
@@ -0,0 +1,280 @@
+#pragma once
+
+/**
+ * @file Profiler.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Opt-in CPU time per stage of a running plugin.
+ * @details Stages are marked with NTFX_PROFILE_SCOPE(), which times the rest
+ * of the enclosing scope and adds the time to a Table. A plugin has a table,
+ * 'profile', and the sample rate converter marks the upsampler, the plugin and
+ * the downsampler in it. Nothing of this is compiled unless NTFX_PROFILE is
+ * defined, so a normal build pays nothing for the scopes left in the code.
+ *
+ * Times are inclusive: a scope inside another counts towards both. Timing
+ * costs some tens of cycles per scope, more than many a process() call, so
+ * place scopes around whole blocks, e.g. in processBlock(), and never in code
+ * that runs once per sample.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define NTFX_PROFILE_TSC
+#elif defined(_M_X64) || defined(_M_IX86)
+  #include <intrin.h>
+  #define NTFX_PROFILE_TSC
+#endif
+
+namespace NtFx {
+namespace Profile {
+  /**
+   * @brief Maximum number of distinct stage names in a program. Further
+   * stages are not timed.
+   */
+  constexpr size_t nStagesMax = 32;
+
+#ifdef NTFX_PROFILE_TSC
+  constexpr const char* tickUnit = "cycles"; ///< Unit of now().
+#else
+  constexpr const char* tickUnit = "ns"; ///< Unit of now().
+#endif
+
+  /**
+   * @brief Current time in ticks. The time stamp counter where there is one,
+   * as it is cheaper to read than the OS clock.
+   */
+  inline uint64_t now() noexcept {
+#ifdef NTFX_PROFILE_TSC
+    return __rdtsc();
+#else
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+                        .count());
+#endif
+  }
+
+  /**
+   * @brief Names of all stages, by slot. Shared by all tables, so a slot
+   * means the same stage in every plugin instance. Slots are only added, and
+   * the used ones come first, so they can be read without locking.
+   */
+  struct Registry {
+    std::array<std::atomic<const char*>, nStagesMax> names {};
+
+    static Registry& get() {
+      static Registry registry;
+      return registry;
+    }
+  };
+
+  /**
+   * @brief Slot of a stage name, added if it is new. Call once per call site
+   * and keep the result, as NTFX_PROFILE_SCOPE() does. Lock-free, since the
+   * first call usually happens on the audio thread. A new name claims the
+   * first free slot with a compare and swap, and a thread losing the race
+   * goes on with the name that won it.
+   *
+   * @param name Name of stage. Must outlive the program, e.g. a literal.
+   * @return size_t Slot, or nStagesMax if the registry is full.
+   */
+  inline size_t slot(const char* name) noexcept {
+    auto& r = Registry::get();
+    for (size_t i = 0; i < nStagesMax; i++) {
+      const char* p_name = r.names[i].load(std::memory_order_acquire);
+      if (!p_name
+          && r.names[i].compare_exchange_strong(
+              p_name, name, std::memory_order_acq_rel)) {
+        return i;
+      }
+      if (!std::strcmp(p_name, name)) { return i; }
+    }
+    return nStagesMax;
+  }
+
+  /**
+   * @brief Accumulated time of a stage as read by Table::read().
+   */
+  struct Entry {
+    std::string name;   ///< Name of stage.
+    uint64_t ticks = 0; ///< Total time in ticks.
+    uint64_t calls = 0; ///< Number of times the stage ran.
+  };
+
+  /**
+   * @brief Accumulated time per stage of one plugin instance. Written by the
+   * audio thread only and read from any thread without locking. Copying a
+   * table gives an empty table, since the times belong to the original.
+   */
+  struct Table {
+    /**
+     * @brief Time of one stage. Only the audio thread writes, so the counters
+     * are updated with plain loads and stores rather than read-modify-write.
+     */
+    struct Stage {
+      std::atomic<uint64_t> ticks { 0 };
+      std::atomic<uint64_t> calls { 0 };
+    };
+    std::array<Stage, nStagesMax> stages;
+
+    Table() = default;
+    Table(const Table&) { }
+    Table& operator=(const Table&) noexcept { return *this; }
+
+    /**
+     * @brief Adds the time of one run of a stage. Audio thread only.
+     *
+     * @param iSlot Slot of stage.
+     * @param ticks Time in ticks.
+     */
+    inline void add(size_t iSlot, uint64_t ticks) noexcept {
+      if (iSlot >= nStagesMax) { return; }
+      auto& s = this->stages[iSlot];
+      s.ticks.store(s.ticks.load(std::memory_order_relaxed) + ticks,
+          std::memory_order_relaxed);
+      s.calls.store(s.calls.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Adds all times of another table, e.g. to sum the tables of
+     * several instances. Not for a table in use on an audio thread.
+     */
+    void add(const Table& other) noexcept {
+      for (size_t i = 0; i < nStagesMax; i++) {
+        auto& s = this->stages[i];
+        auto& o = other.stages[i];
+        s.ticks.store(s.ticks.load(std::memory_order_relaxed)
+                + o.ticks.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+        s.calls.store(s.calls.load(std::memory_order_relaxed)
+                + o.calls.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+      }
+    }
+
+    /**
+     * @brief Reads the stages that have run. Allocates, so do not call from
+     * the audio thread. Ticks and calls of a stage may be one run apart.
+     */
+    std::vector<Entry> read() const {
+      auto& r = Registry::get();
+      std::vector<Entry> entries;
+      for (size_t i = 0; i < nStagesMax; i++) {
+        const char* p_name = r.names[i].load(std::memory_order_acquire);
+        if (!p_name) { break; }
+        const auto& s    = this->stages[i];
+        const auto calls = s.calls.load(std::memory_order_relaxed);
+        if (!calls) { continue; }
+        entries.push_back(
+            { p_name, s.ticks.load(std::memory_order_relaxed), calls });
+      }
+      return entries;
+    }
+
+    /**
+     * @brief Writes the table as CSV.
+     */
+    void write(std::ostream& os) const {
+      os << "stage,calls," << tickUnit << "," << tickUnit << "_per_call\n";
+      for (const auto& e : this->read()) {
+        os << e.name << "," << e.calls << "," << e.ticks << ","
+           << e.ticks / e.calls << "\n";
+      }
+    }
+
+    /**
+     * @brief Writes the table as CSV to a file.
+     *
+     * @return bool True on success.
+     */
+    bool dump(const std::string& path) const {
+      std::ofstream file(path, std::ios::trunc);
+      this->write(file);
+      return bool(file);
+    }
+  };
+
+  /**
+   * @brief Adds the time from construction to destruction to a stage.
+   */
+  struct Scope {
+    Table& table;
+    size_t iSlot;
+    uint64_t t0;
+
+    Scope(Table& table, size_t iSlot) noexcept
+        : table(table), iSlot(iSlot), t0(now()) { }
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() { this->table.add(this->iSlot, now() - this->t0); }
+  };
+
+  /**
+   * @brief Time spent in each stage between two reads of the same table, e.g.
+   * to show the current load rather than the load since the plugin loaded.
+   *
+   * @param current Newer read.
+   * @param previous Older read.
+   * @return std::vector<Entry> Stages that ran in between.
+   */
+  inline std::vector<Entry> diff(
+      const std::vector<Entry>& current, const std::vector<Entry>& previous) {
+    std::vector<Entry> entries;
+    for (const auto& e : current) {
+      Entry d = e;
+      for (const auto& p : previous) {
+        if (p.name == e.name) {
+          d.ticks -= p.ticks;
+          d.calls -= p.calls;
+          break;
+        }
+      }
+      if (d.calls) { entries.push_back(d); }
+    }
+    return entries;
+  }
+}
+}
+
+#define _NTFX_PROFILE_CAT2(a, b) a##b
+#define _NTFX_PROFILE_CAT(a, b) _NTFX_PROFILE_CAT2(a, b)
+
+#ifdef NTFX_PROFILE
+  /**
+   * @brief Times the rest of the enclosing scope as stage 'name' in 'table',
+   * a Profile::Table. The slot is looked up the first time the line runs.
+   * Expands to nothing unless NTFX_PROFILE is defined.
+   */
+  #define NTFX_PROFILE_SCOPE(table, name)                                      \
+    static const size_t _NTFX_PROFILE_CAT(_ntfxProfileSlot, __LINE__)          \
+        = NtFx::Profile::slot(name);                                           \
+    NtFx::Profile::Scope _NTFX_PROFILE_CAT(_ntfxProfileScope, __LINE__)(       \
+        table, _NTFX_PROFILE_CAT(_ntfxProfileSlot, __LINE__))
+#else
+  #define NTFX_PROFILE_SCOPE(table, name) static_assert(true)
+#endif
@@ -24,39 +24,50 @@
  */
 
 #include "Component.h"
+#include "gcem.hpp"
 #include "Stereo.h"
 #include <algorithm>
-#include <array>
+#include <vector>
 
 namespace NtFx {
 
+/**
+ * @brief Averaging of the RMS sensor.
+ */
+enum struct RmsMode {
+  window,      ///< Moving average over 't_ms' in steps of one millisecond.
+  exponential, ///< First order lowpass. No delay line, for cheap meters.
+};
+
 /**
  * @brief RMS (Root Mean Square) sensor component for audio signal processing
  *
  * This component calculates the RMS value of an audio signal over a specified
- * time period. It maintains two delay lines: one for sample-level accumulation
- * and one for millisecond-level accumulation, allowing for efficient RMS
- * calculation.
+ * time period. Squares are summed over one millisecond at a time, and the
+ * millisecond sums are kept in a delay line with a running sum over the
+ * window. The running sum is recalculated from the delay line every time it
+ * wraps, so rounding errors never build up, however long it runs.
+ *
+ * The delay line is allocated in reset() from 'maxT_ms'. Windows set later
+ * with setT_ms() are limited to that, so setT_ms() can be called from the
+ * audio thread.
  *
  * @tparam signal_t The type of the audio signal (e.g., float, double)
- * @tparam maxT_ms Maximum time window in milliseconds for RMS calculation
- * (default: 1000)
- * @tparam maxSampleDLineLen Maximum length of the sample delay line (default:
- * 192 * 8)
  */
-template <typename signal_t,
-    int maxT_ms           = 1000,
-    int maxSampleDLineLen = 192 * 8>
+template <typename signal_t>
 struct RmsSensor : public Component<signal_t> {
-  std::array<signal_t, maxSampleDLineLen> samleDLine; ///< Sample delay line.
-  std::array<signal_t, maxT_ms> msDLine; ///< Millisecond delay line.
-  signal_t sampleAccum { 0 }; ///< Accumulator for current sample values.
-  signal_t msAccum { 0 };     ///< Accumulator for millisecond-level values.
-  int sampleIdx { 0 };        ///< Current index in the sample delay line.
-  int msIdx { 0 };            ///< Current index in the millisecond delay line.
-  bool resetAccums { false }; ///< Flag to reset accumulators.
-  int msDLineLen { maxT_ms }; ///< Current time window in milliseconds.
-  int sampleDLineLen { 48 };  ///< Length of sample delay line.
+  std::vector<signal_t> msDLine; ///< Millisecond delay line.
+  signal_t sampleAccum { 0 };    ///< Accumulator for the current millisecond.
+  signal_t msAccum { 0 };        ///< Accumulator for millisecond-level values.
+  signal_t expState { 0 };       ///< Mean square in exponential mode.
+  signal_t alpha { 0 };          ///< Coefficient of exponential mode.
+  int sampleIdx { 0 };           ///< Samples in the current millisecond.
+  int msIdx { 0 };               ///< Index in the millisecond delay line.
+  bool resetAccums { false };    ///< Flag to reset accumulators.
+  int maxT_ms { 1000 };          ///< Longest time window. Used by reset().
+  int msDLineLen { 1000 };       ///< Current time window in milliseconds.
+  int sampleDLineLen { 48 };     ///< Samples per millisecond.
+  RmsMode mode { RmsMode::window };
 
   /**
    * @brief Process the input signal and update RMS calculation
@@ -72,6 +83,14 @@ struct RmsSensor : public Component<signal_t> {
     return this->getRms();
   }
 
+  virtual void processBlock(
+      const signal_t* x, signal_t* y, size_t n) noexcept override {
+    for (size_t i = 0; i < n; i++) {
+      this->processDelayLine(x[i]);
+      y[i] = this->getRms();
+    }
+  }
+
   /**
    * @brief Processes accumulators and update delay lines without calculating
    * result. To be called each sample if 'process' is not used. This way, you
@@ -83,28 +102,86 @@ struct RmsSensor : public Component<signal_t> {
   void processDelayLine(signal_t x) noexcept {
     auto x2 = x * x;
     if (x2 != x2) { x2 = signal_t(0.0); }
-    this->sampleAccum += x2 - this->samleDLine[this->sampleIdx];
-    this->samleDLine[this->sampleIdx] = x2;
+    if (this->mode == RmsMode::exponential) {
+      this->expState = this->alpha * this->expState + (1 - this->alpha) * x2;
+      return;
+    }
+    this->sampleAccum += x2;
     if (++this->sampleIdx < this->sampleDLineLen) { return; }
+    this->_pushMs();
+  }
+
+  /**
+   * @brief Block version of processDelayLine(). Squares are summed in
+   * registers up to the end of each millisecond, so the delay line is only
+   * touched once per millisecond.
+   *
+   * @param x Input samples.
+   * @param n Number of samples.
+   * @param stride Distance between samples in 'x', e.g. 2 for one channel of
+   * interleaved stereo.
+   */
+  void processDelayLineBlock(
+      const signal_t* x, size_t n, size_t stride = 1) noexcept {
+    if (this->mode == RmsMode::exponential) {
+      const signal_t alpha = this->alpha;
+      signal_t state       = this->expState;
+      for (size_t i = 0; i < n; i++) {
+        auto x2 = x[i * stride] * x[i * stride];
+        if (x2 != x2) { x2 = signal_t(0.0); }
+        state = alpha * state + (1 - alpha) * x2;
+      }
+      this->expState = state;
+      return;
+    }
+    for (size_t i0 = 0; i0 < n;) {
+      const size_t m = std::min(n - i0,
+          size_t(std::max(this->sampleDLineLen - this->sampleIdx, 1)));
+      signal_t accum = 0;
+      for (size_t i = i0; i < i0 + m; i++) {
+        auto x2 = x[i * stride] * x[i * stride];
+        if (x2 != x2) { x2 = signal_t(0.0); }
+        accum += x2;
+      }
+      this->sampleAccum += accum;
+      this->sampleIdx += int(m);
+      i0 += m;
+      if (this->sampleIdx >= this->sampleDLineLen) { this->_pushMs(); }
+    }
+  }
+
+  /**
+   * @brief Moves the sum of the millisecond just completed to the delay line
+   * and updates the running sum.
+   */
+  inline void _pushMs() noexcept {
     this->sampleIdx = 0;
-    this->msAccum += sampleAccum - this->msDLine[this->msIdx];
-    this->msDLine[this->msIdx] = sampleAccum;
-    if (++this->msIdx >= this->msDLineLen) { this->msIdx = 0; }
+    if (this->msDLine.empty()) { return; }
+    this->msAccum += this->sampleAccum - this->msDLine[this->msIdx];
+    this->msDLine[this->msIdx] = this->sampleAccum;
+    this->sampleAccum          = 0;
+    if (++this->msIdx < this->msDLineLen) { return; }
+    this->msIdx   = 0;
+    this->msAccum = 0;
+    for (int i = 0; i < this->msDLineLen; i++) {
+      this->msAccum += this->msDLine[i];
+    }
   }
 
   /**
    * @brief Update the component state
    *
    * This method resets the accumulators and delay lines if the resetAccums flag
-   * is set.
+   * is set, and calculates the coefficient of the exponential mode.
    */
   virtual void update() noexcept override {
+    this->alpha = gcem::exp(-2200.0 / (this->msDLineLen * this->fs));
     if (this->resetAccums) {
       this->sampleIdx   = 0;
       this->msIdx       = 0;
       this->sampleAccum = 0;
       this->msAccum     = 0;
-      std::fill(this->samleDLine.begin(), this->samleDLine.end(), 0);
+      this->expState    = 0;
       std::fill(this->msDLine.begin(), this->msDLine.end(), 0);
       this->resetAccums = false;
     }
@@ -113,15 +190,17 @@ struct RmsSensor : public Component<signal_t> {
   /**
    * @brief Reset the component with a new sample rate
    *
-   * This method updates the sample rate and recalculates the sample delay line
-   * length based on the new rate.
+   * This method updates the sample rate, allocates the delay line and
+   * recalculates the number of samples per millisecond.
    *
    * @param fs The new sample rate in Hz
    */
   virtual void reset(float fs) noexcept override {
     this->fs             = fs;
-    this->sampleDLineLen = fs / 1000;
-    this->resetAccums    = true;
+    this->sampleDLineLen = std::max(int(fs / 1000), 1);
+    this->msDLine.assign(this->maxT_ms, 0);
+    this->msDLineLen  = std::clamp(this->msDLineLen, 1, this->maxT_ms);
+    this->resetAccums = true;
     this->update();
   }
 
@@ -134,8 +213,13 @@ struct RmsSensor : public Component<signal_t> {
    * @return The current RMS value
    */
   signal_t getRms() const noexcept {
-    signal_t y = gcem::sqrt(signal_t(2.0) * this->msAccum
-        / signal_t(this->sampleDLineLen * this->msDLineLen));
+    signal_t y;
+    if (this->mode == RmsMode::exponential) {
+      y = gcem::sqrt(signal_t(2.0) * this->expState);
+    } else {
+      y = gcem::sqrt(signal_t(2.0) * this->msAccum
+          / signal_t(this->sampleDLineLen * this->msDLineLen));
+    }
     if (y != y) { y = signal_t(0.0); }
     return y;
   }
@@ -144,16 +228,28 @@ struct RmsSensor : public Component<signal_t> {
    * @brief Set the time window for RMS calculation
    *
    * This method updates the time window in milliseconds and resets the
-   * accumulators.
+   * accumulators. The window is limited to 'maxT_ms' once allocated.
    *
    * @param t_ms The new time window in milliseconds
    */
   void setT_ms(int t_ms) {
+    t_ms = std::max(t_ms, 1);
+    if (!this->msDLine.empty()) { t_ms = std::min(t_ms, this->maxT_ms); }
     if (t_ms == this->msDLineLen) { return; }
     this->msDLineLen  = t_ms;
     this->resetAccums = true;
     this->update();
   }
+
+  /**
+   * @brief Set the longest time window. Takes effect on reset().
+   *
+   * @param maxT_ms Longest time window in milliseconds.
+   */
+  void setMaxT_ms(int maxT_ms) {
+    this->maxT_ms    = std::max(maxT_ms, 1);
+    this->msDLineLen = std::min(this->msDLineLen, this->maxT_ms);
+  }
 };
 
 /**
@@ -163,16 +259,19 @@ struct RmsSensor : public Component<signal_t> {
  * maintaining two RmsSensor instances (one for each channel).
  *
  * @tparam signal_t The type of the audio signal (e.g., float, double)
- * @tparam maxT_ms Maximum time window in milliseconds for RMS calculation
- * (default: 1000)
- * @tparam maxSampleDLineLen Maximum length of the sample delay line (default:
- * 192 * 8)
  */
-template <typename signal_t,
-    int maxT_ms           = 1000,
-    int maxSampleDLineLen = 192 * 8>
-struct RmsSensorStereo : public StereoComponent<signal_t,
-                             RmsSensor<signal_t, maxT_ms, maxSampleDLineLen>> {
+template <typename signal_t>
+struct RmsSensorStereo
+    : public StereoComponent<signal_t, RmsSensor<signal_t>> {
+  RmsSensorStereo() = default;
+
+  /**
+   * @brief Constructor
+   * @param maxT_ms Longest time window in milliseconds, also used as the
+   * window until setT_ms() is called.
+   */
+  RmsSensorStereo(int maxT_ms) { this->setMaxT_ms(maxT_ms); }
+
   /**
    * @brief Set the time window for RMS calculation
    *
@@ -184,6 +283,40 @@ struct RmsSensorStereo : public StereoComponent<signal_t,
     this->l.setT_ms(t_ms);
     this->r.setT_ms(t_ms);
   }
+
+  /**
+   * @brief Set the longest time window for both channels.
+   *
+   * @param maxT_ms Longest time window in milliseconds.
+   */
+  void setMaxT_ms(int maxT_ms) {
+    this->l.setMaxT_ms(maxT_ms);
+    this->r.setMaxT_ms(maxT_ms);
+  }
+
+  /**
+   * @brief Set the averaging of both channels.
+   *
+   * @param mode Window or exponential.
+   */
+  void setMode(RmsMode mode) {
+    this->l.mode = mode;
+    this->r.mode = mode;
+  }
+
+  /**
+   * @brief Updates the accumulators with a block of samples without
+   * calculating the RMS value for every sample.
+   *
+   * @param x Input samples.
+   * @param n Number of samples.
+   */
+  void processDelayLineBlock(const Stereo<signal_t>* x, size_t n) noexcept {
+    static_assert(sizeof(Stereo<signal_t>) == 2 * sizeof(signal_t));
+    auto p_x = reinterpret_cast<const signal_t*>(x);
+    this->l.processDelayLineBlock(p_x, n, 2);
+    this->r.processDelayLineBlock(p_x + 1, n, 2);
+  }
   /**
    * @brief Get the current RMS values for both channels
    *
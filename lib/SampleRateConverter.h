@@ -22,6 +22,8 @@
 
 #include NTFX_PLUGIN_FILE
 #include "Stereo.h"
+#include "lib/Profiler.h"
+#include "lib/Simd.h"
 #include "lib/windowFunctions.h"
 #include <algorithm>
 #include <array>
@@ -33,6 +35,10 @@ namespace Src {
    * @brief Delay line size for interpolation and antialiasing
    */
   constexpr int nDelayLine = 192;
+  /**
+   * @brief Length of the high sample rate buffer used by block processing.
+   */
+  constexpr size_t nBlockHi = 256;
   /**
    * @brief Oversampling FIR multiplier for high quality mode
    */
@@ -50,17 +56,265 @@ namespace Src {
    */
   enum oversamplingMode : int {
     disable = 1,
-    // iir_2x,
-    // iir_4x,
-    // iir_8x,
     fir_2x_lq,
     fir_4x_lq,
     fir_8x_lq,
     fir_2x_hq,
     fir_4x_hq,
     fir_8x_hq,
-    end = fir_8x_hq
+    hb_2x,
+    hb_4x,
+    hb_8x,
+    hb_16x,
+    iir_2x,
+    iir_4x,
+    iir_8x,
+    end = iir_8x
+  };
+  /**
+   * @brief Maximum number of cascaded half-band stages.
+   */
+  constexpr size_t nHalfBandStages = 4;
+  /**
+   * @brief Half-band kernel length per stage, counted from the base sample
+   * rate. The first stage needs the steepest transition band. Later stages
+   * only have to reject images far above the audio band and get by with
+   * shorter kernels.
+   */
+  constexpr std::array<size_t, nHalfBandStages> halfBandLen { 47, 23, 15, 11 };
+
+  /**
+   * @brief One 2x stage of a half-band cascade. Holds both the upsampling and
+   * the downsampling filter state. Since every other tap is zero, each
+   * polyphase branch is either a plain delay or an FIR with half the taps.
+   * @tparam signal_t Type of signal samples
+   */
+  template <typename signal_t>
+  struct HalfBand {
+    /**
+     * @brief Maximum number of nonzero taps in the FIR branch.
+     */
+    static constexpr size_t nTapsMax = 32;
+    /**
+     * @brief Taps in the FIR branch. The kernel has 2 * nTaps - 1 taps.
+     */
+    size_t nTaps { 0 };
+    /**
+     * @brief FIR branch coefficients, duplicated for Simd::dotStereo().
+     */
+    alignas(16) std::array<signal_t, nTapsMax * 2> b;
+    /**
+     * @brief Input delay line of the upsampler.
+     */
+    std::array<Stereo<signal_t>, nTapsMax * 2> dlUp;
+    /**
+     * @brief Even samples at the high rate, input to the downsampler.
+     */
+    std::array<Stereo<signal_t>, nTapsMax * 2> dlEven;
+    /**
+     * @brief Odd samples at the high rate, input to the downsampler.
+     */
+    std::array<Stereo<signal_t>, nTapsMax * 2> dlOdd;
+    size_t iUp { 0 };   ///< Store index for 'dlUp'.
+    size_t iDown { 0 }; ///< Store index for 'dlEven' and 'dlOdd'.
+
+    /**
+     * @brief Designs the filter and clears the state.
+     * @param len Kernel length. Must be 4 * m - 1
+     */
+    void reset(size_t len) {
+      auto h      = halfBand<signal_t>(len);
+      this->nTaps = (len + 1) / 2;
+      for (size_t j = 0; j < this->nTaps; j++) {
+        this->b[2 * j]     = h[2 * j];
+        this->b[2 * j + 1] = h[2 * j];
+      }
+      this->iUp   = 0;
+      this->iDown = 0;
+      std::fill(this->dlUp.begin(), this->dlUp.end(), 0.0);
+      std::fill(this->dlEven.begin(), this->dlEven.end(), 0.0);
+      std::fill(this->dlOdd.begin(), this->dlOdd.end(), 0.0);
+    }
+
+    /**
+     * @brief Group delay of upsampling and downsampling combined.
+     * @return Delay in samples at the low rate of the stage
+     */
+    float getLatency() const noexcept { return float(this->nTaps - 1); }
+
+    /**
+     * @brief Upsamples by two.
+     * @param x Input samples
+     * @param y Output samples. Length 2 * n. Must not overlap 'x'
+     * @param n Number of input samples
+     */
+    inline void upBlock(
+        const Stereo<signal_t>* x, Stereo<signal_t>* y, size_t n) noexcept {
+      const size_t nTaps = this->nTaps;
+      const size_t delay = nTaps / 2 - 1;
+      for (size_t i = 0; i < n; i++) {
+        this->dlUp[this->iUp]            = x[i];
+        this->dlUp[this->iUp + nTapsMax] = x[i];
+        if (++this->iUp >= nTapsMax) { this->iUp = 0; }
+        // Newest sample is at 'p_x[nTaps - 1]'.
+        auto p_x = this->dlUp.data() + this->iUp + nTapsMax - nTaps;
+        y[2 * i] = Simd::dotStereo(this->b.data(), p_x, nTaps) * signal_t(2);
+        y[2 * i + 1] = p_x[nTaps - 1 - delay];
+      }
+    }
+
+    /**
+     * @brief Downsamples by two.
+     * @param x Input samples. Length 2 * n
+     * @param y Output samples. May be the same buffer as 'x'
+     * @param n Number of output samples
+     */
+    inline void downBlock(
+        const Stereo<signal_t>* x, Stereo<signal_t>* y, size_t n) noexcept {
+      const size_t nTaps = this->nTaps;
+      const size_t delay = nTaps / 2;
+      for (size_t i = 0; i < n; i++) {
+        this->dlEven[this->iDown]            = x[2 * i];
+        this->dlEven[this->iDown + nTapsMax] = x[2 * i];
+        this->dlOdd[this->iDown]             = x[2 * i + 1];
+        this->dlOdd[this->iDown + nTapsMax]  = x[2 * i + 1];
+        if (++this->iDown >= nTapsMax) { this->iDown = 0; }
+        auto p_even = this->dlEven.data() + this->iDown + nTapsMax - nTaps;
+        auto p_odd  = this->dlOdd.data() + this->iDown + nTapsMax - 1;
+        y[i] = Simd::dotStereo(this->b.data(), p_even, nTaps)
+            + p_odd[-ptrdiff_t(delay)] * signal_t(0.5);
+      }
+    }
+  };
+  /**
+   * @brief Maximum number of cascaded allpass half-band stages.
+   */
+  constexpr size_t nAllpassStages = 3;
+  /**
+   * @brief Number of coefficients per allpass half-band stage, counted from
+   * the base sample rate.
+   */
+  constexpr std::array<size_t, nAllpassStages> allpassNCoeffs { 8, 4, 3 };
+  /**
+   * @brief Transition bandwidth per allpass half-band stage, relative to the
+   * high sample rate of the stage. The first stage keeps the audio band, later
+   * stages only need to reject images above the band of the previous stage.
+   */
+  constexpr std::array<double, nAllpassStages> allpassTransition {
+    0.04, 0.12, 0.19
+  };
+
+  /**
+   * @brief One 2x stage of a polyphase allpass half-band cascade. Each
+   * polyphase branch is a chain of first order allpass sections running at
+   * the low rate. Not linear phase, but only a few samples of group delay and
+   * far fewer operations than the FIR stages.
+   * @tparam signal_t Type of signal samples
+   */
+  template <typename signal_t>
+  struct AllpassHalfBand {
+    /**
+     * @brief Maximum number of coefficients.
+     */
+    static constexpr size_t nCoeffsMax = 12;
+    /**
+     * @brief Number of coefficients. Even ones belong to the first branch.
+     */
+    size_t nCoeffs { 0 };
+    /**
+     * @brief Allpass coefficients.
+     */
+    std::array<signal_t, nCoeffsMax> a;
+    std::array<Stereo<signal_t>, nCoeffsMax> xUp; ///< Upsampler inputs.
+    std::array<Stereo<signal_t>, nCoeffsMax> yUp; ///< Upsampler outputs.
+    std::array<Stereo<signal_t>, nCoeffsMax> xDown; ///< Downsampler inputs.
+    std::array<Stereo<signal_t>, nCoeffsMax> yDown; ///< Downsampler outputs.
+
+    /**
+     * @brief Designs the filter and clears the state.
+     * @param nCoeffs Number of coefficients
+     * @param transition Transition bandwidth relative to the high sample rate
+     */
+    void reset(size_t nCoeffs, double transition) {
+      auto a        = allpassHalfBand<signal_t>(nCoeffs, transition);
+      this->nCoeffs = nCoeffs;
+      std::copy(a.begin(), a.end(), this->a.begin());
+      std::fill(this->xUp.begin(), this->xUp.end(), 0.0);
+      std::fill(this->yUp.begin(), this->yUp.end(), 0.0);
+      std::fill(this->xDown.begin(), this->xDown.end(), 0.0);
+      std::fill(this->yDown.begin(), this->yDown.end(), 0.0);
+    }
+
+    /**
+     * @brief Group delay at DC of upsampling and downsampling combined. A first
+     * order allpass section in z^2 delays DC by 2 * (1 - a) / (1 + a) samples
+     * at the high rate, and the half-band filter delays by the mean of its two
+     * branches. The second branch runs a sample late in the upsampler, but the
+     * downsampler feeds it the earlier sample of each pair, which cancels it.
+     * @return Delay in samples at the low rate of the stage
+     */
+    float getLatency() const noexcept {
+      double tau = 0;
+      for (size_t i = 0; i < this->nCoeffs; i++) {
+        tau += 2 * (1 - double(this->a[i])) / (1 + double(this->a[i]));
+      }
+      return float(tau / 2);
+    }
+
+    /**
+     * @brief Runs both branches over one pair of samples.
+     * @param x0 Input and output of the first branch
+     * @param x1 Input and output of the second branch
+     * @param xn1 Previous section inputs
+     * @param yn1 Previous section outputs
+     */
+    inline void _branches(Stereo<signal_t>& x0,
+        Stereo<signal_t>& x1,
+        Stereo<signal_t>* xn1,
+        Stereo<signal_t>* yn1) const noexcept {
+      for (size_t i = 0; i < this->nCoeffs; i++) {
+        auto& x = i % 2 ? x1 : x0;
+        auto y  = (x - yn1[i]) * this->a[i] + xn1[i];
+        xn1[i]  = x;
+        yn1[i]  = y;
+        x       = y;
+      }
+    }
+
+    /**
+     * @brief Upsamples by two.
+     * @param x Input samples
+     * @param y Output samples. Length 2 * n. Must not overlap 'x'
+     * @param n Number of input samples
+     */
+    inline void upBlock(
+        const Stereo<signal_t>* x, Stereo<signal_t>* y, size_t n) noexcept {
+      for (size_t i = 0; i < n; i++) {
+        auto y0 = x[i];
+        auto y1 = x[i];
+        this->_branches(y0, y1, this->xUp.data(), this->yUp.data());
+        y[2 * i]     = y0;
+        y[2 * i + 1] = y1;
+      }
+    }
+
+    /**
+     * @brief Downsamples by two.
+     * @param x Input samples. Length 2 * n
+     * @param y Output samples. May be the same buffer as 'x'
+     * @param n Number of output samples
+     */
+    inline void downBlock(
+        const Stereo<signal_t>* x, Stereo<signal_t>* y, size_t n) noexcept {
+      for (size_t i = 0; i < n; i++) {
+        auto y0 = x[2 * i + 1];
+        auto y1 = x[2 * i];
+        this->_branches(y0, y1, this->xDown.data(), this->yDown.data());
+        y[i] = (y0 + y1) * signal_t(0.5);
+      }
+    }
   };
+
   /**
    * @brief State structure for sample rate converter
    * @tparam signal_t Type of signal samples
@@ -84,6 +338,18 @@ namespace Src {
      * sample rate).
      */
     std::array<Stereo<signal_t>, nDelayLine * 2> dlAntialiasing;
+    /**
+     * @brief Upsampled samples handed to the plugin.
+     */
+    std::array<Stereo<signal_t>, nBlockHi> hi;
+    /**
+     * @brief Side chain held at the high sample rate.
+     */
+    std::array<signal_t, nBlockHi> hiSc;
+    /**
+     * @brief Second high rate buffer for the half-band cascade.
+     */
+    std::array<Stereo<signal_t>, nBlockHi> hiTmp;
   };
   /**
    * @brief Coefficients structure for sample rate converter
@@ -99,6 +365,14 @@ namespace Src {
      * @brief Oversampling factor
      */
     size_t osFactor = 1;
+    /**
+     * @brief Number of half-band stages. Zero for the single stage FIR modes.
+     */
+    size_t nHalfBands = 0;
+    /**
+     * @brief Use allpass half-band stages rather than FIR half-band stages.
+     */
+    bool iir = false;
     /**
      * @brief FIR filter length multiplier
      */
@@ -111,10 +385,26 @@ namespace Src {
      * @brief High sampling rate
      */
     signal_t fsHi = 48000;
+    /**
+     * @brief Group delay of the up and down filters in samples at the base
+     * sample rate. For the iir modes, this is the group delay at DC.
+     */
+    float latency = 0;
     /**
      * @brief FIR filter coefficients
      */
     std::array<signal_t, nDelayLine> b;
+    /**
+     * @brief Polyphase interpolation coefficients. One contiguous run of
+     * osFirLenMult taps per phase, time reversed so they line up with the
+     * delay line, scaled by osFactor and stored duplicated for
+     * Simd::dotStereo().
+     */
+    alignas(16) std::array<signal_t, nDelayLine * 2> bUp;
+    /**
+     * @brief Antialiasing coefficients, duplicated for Simd::dotStereo().
+     */
+    alignas(16) std::array<signal_t, nDelayLine * 2> bDown;
   };
   /**
    * @brief Sample rate converter class
@@ -134,6 +424,14 @@ namespace Src {
      * @brief Coefficients of the sample rate converter
      */
     Coeffs<signal_t> coeffs;
+    /**
+     * @brief Half-band stages for the hb modes, from the base sample rate up.
+     */
+    std::array<HalfBand<signal_t>, nHalfBandStages> halfBands;
+    /**
+     * @brief Allpass half-band stages for the iir modes.
+     */
+    std::array<AllpassHalfBand<signal_t>, nAllpassStages> allpassHalfBands;
     /**
      * @brief Oversampling mode
      */
@@ -155,51 +453,204 @@ namespace Src {
      * @return Processed audio samples
      */
     Stereo<signal_t> process(Stereo<signal_t> x) {
+      // Not profiled, as timing stages this short would cost more than them.
       if (this->coeffs.disable) { return this->plug.process(x); }
-      this->state.dlInterpolation[this->state.iStoreIn]              = x;
-      this->state.dlInterpolation[this->state.iStoreIn + nDelayLine] = x;
-      if (++this->state.iStoreIn >= nDelayLine) { this->state.iStoreIn = 0; }
-      auto iReadIn = this->state.iStoreIn + nDelayLine;
+      auto p_hi = this->state.hi.data();
+      if (this->coeffs.nHalfBands) {
+        this->_upsampleHalfBands(&x, 1);
+      } else {
+        this->_upsample(x, p_hi);
+      }
       for (size_t i = 0; i < this->coeffs.osFactor; i++) {
-        Stereo<signal_t> accum;
-        for (size_t j = 0; j < this->coeffs.osFirLenMult; j++) {
-          accum += this->coeffs.b[j * this->coeffs.osFactor + i]
-              * this->state.dlInterpolation[iReadIn - j];
+        p_hi[i] = this->plug.process(p_hi[i]);
+      }
+      if (this->coeffs.nHalfBands) {
+        Stereo<signal_t> y;
+        this->_downsampleHalfBands(&y, 1);
+        return y;
+      }
+      return this->_downsample(p_hi);
+    }
+
+    /**
+     * @brief Process a block of audio samples through the sample rate
+     * converter. The block is upsampled in chunks of up to nBlockHi samples at
+     * the high rate, each chunk is handed to the plugin in one call and then
+     * downsampled. The side chain is held for osFactor samples at the high
+     * rate, like in process().
+     * @param x Input audio samples
+     * @param y Output audio samples. May be the same buffer as 'x'.
+     * @param n Number of samples
+     * @param xSc Side chain samples at base sample rate or nullptr if not
+     * connected
+     */
+    void processBlock(const Stereo<signal_t>* x,
+        Stereo<signal_t>* y,
+        size_t n,
+        const signal_t* xSc = nullptr) {
+      if (this->coeffs.disable) {
+        NTFX_PROFILE_SCOPE(this->plug.profile, "plugin");
+        this->plug.xScBlock = xSc;
+        this->plug.processBlock(x, y, n);
+        this->plug.xScBlock = nullptr;
+        return;
+      }
+      const size_t osFactor = this->coeffs.osFactor;
+      const size_t nChunk   = nBlockHi / osFactor;
+      auto p_hi             = this->state.hi.data();
+      auto p_hiSc           = this->state.hiSc.data();
+      for (size_t i0 = 0; i0 < n; i0 += nChunk) {
+        const size_t m = std::min(nChunk, n - i0);
+        {
+          NTFX_PROFILE_SCOPE(this->plug.profile, "src.up");
+          if (this->coeffs.nHalfBands) {
+            this->_upsampleHalfBands(x + i0, m);
+          } else {
+            for (size_t k = 0; k < m; k++) {
+              this->_upsample(x[i0 + k], p_hi + k * osFactor);
+            }
+          }
+          if (xSc) {
+            for (size_t k = 0; k < m; k++) {
+              std::fill_n(p_hiSc + k * osFactor, osFactor, xSc[i0 + k]);
+            }
+            this->plug.xScBlock = p_hiSc;
+          }
         }
-        auto xProc = accum * this->coeffs.osFactor;
-        auto yProc = this->plug.process(xProc);
-        this->state.dlAntialiasing[this->state.iStoreOut]              = yProc;
-        this->state.dlAntialiasing[this->state.iStoreOut + nDelayLine] = yProc;
-        if (++this->state.iStoreOut >= nDelayLine) {
-          this->state.iStoreOut = 0;
+        {
+          NTFX_PROFILE_SCOPE(this->plug.profile, "plugin");
+          this->plug.processBlock(p_hi, p_hi, m * osFactor);
+          this->plug.xScBlock = nullptr;
         }
+        NTFX_PROFILE_SCOPE(this->plug.profile, "src.down");
+        if (this->coeffs.nHalfBands) {
+          this->_downsampleHalfBands(y + i0, m);
+        } else {
+          for (size_t k = 0; k < m; k++) {
+            y[i0 + k] = this->_downsample(p_hi + k * osFactor);
+          }
+        }
+      }
+    }
+
+    /**
+     * @brief Stores an input sample and computes the osFactor samples at the
+     * high rate, one polyphase branch each.
+     * @param x Input sample
+     * @param xHi Output. osFactor samples at the high rate
+     */
+    inline void _upsample(Stereo<signal_t> x, Stereo<signal_t>* xHi) noexcept {
+      auto& s            = this->state;
+      const size_t nTaps = this->coeffs.osFirLenMult;
+      s.dlInterpolation[s.iStoreIn]              = x;
+      s.dlInterpolation[s.iStoreIn + nDelayLine] = x;
+      if (++s.iStoreIn >= nDelayLine) { s.iStoreIn = 0; }
+      // Oldest of the last nTaps input samples. The newest is 'x'.
+      auto p_x = s.dlInterpolation.data() + s.iStoreIn + nDelayLine - nTaps;
+      auto p_b = this->coeffs.bUp.data();
+      for (size_t i = 0; i < this->coeffs.osFactor; i++) {
+        xHi[i] = Simd::dotStereo(p_b + 2 * i * nTaps, p_x, nTaps);
+      }
+    }
+
+    /**
+     * @brief Stores osFactor processed samples at the high rate and computes
+     * one output sample.
+     * @param yHi osFactor samples at the high rate
+     * @return Output sample
+     */
+    inline Stereo<signal_t> _downsample(const Stereo<signal_t>* yHi) noexcept {
+      auto& s = this->state;
+      for (size_t i = 0; i < this->coeffs.osFactor; i++) {
+        s.dlAntialiasing[s.iStoreOut]              = yHi[i];
+        s.dlAntialiasing[s.iStoreOut + nDelayLine] = yHi[i];
+        if (++s.iStoreOut >= nDelayLine) { s.iStoreOut = 0; }
+      }
+      auto p_y
+          = s.dlAntialiasing.data() + s.iStoreOut + nDelayLine - this->coeffs.n;
+      return Simd::dotStereo(this->coeffs.bDown.data(), p_y, this->coeffs.n);
+    }
+
+    /**
+     * @brief Upsamples through the half-band cascade into 'state.hi'.
+     * @param x Input samples
+     * @param n Number of input samples
+     */
+    inline void _upsampleHalfBands(
+        const Stereo<signal_t>* x, size_t n) noexcept {
+      if (this->coeffs.iir) {
+        this->_upsampleCascade(this->allpassHalfBands, x, n);
+      } else {
+        this->_upsampleCascade(this->halfBands, x, n);
+      }
+    }
+
+    /**
+     * @brief Downsamples 'state.hi' through the half-band cascade.
+     * @param y Output samples
+     * @param n Number of output samples
+     */
+    inline void _downsampleHalfBands(Stereo<signal_t>* y, size_t n) noexcept {
+      if (this->coeffs.iir) {
+        this->_downsampleCascade(this->allpassHalfBands, y, n);
+      } else {
+        this->_downsampleCascade(this->halfBands, y, n);
+      }
+    }
+
+    /**
+     * @brief Upsamples through a cascade of 2x stages into 'state.hi'. The
+     * stages alternate between 'state.hi' and 'state.hiTmp' so that the last
+     * one writes to 'state.hi'.
+     * @param stages Stages, from the base sample rate up
+     * @param x Input samples
+     * @param n Number of input samples
+     */
+    template <typename stages_t>
+    inline void _upsampleCascade(
+        stages_t& stages, const Stereo<signal_t>* x, size_t n) noexcept {
+      const size_t nStages = this->coeffs.nHalfBands;
+      auto p_out           = this->state.hi.data();
+      auto p_other         = this->state.hiTmp.data();
+      if (nStages % 2 == 0) { std::swap(p_out, p_other); }
+      const Stereo<signal_t>* p_in = x;
+      for (size_t s = 0; s < nStages; s++) {
+        stages[s].upBlock(p_in, p_out, n);
+        p_in = p_out;
+        n *= 2;
+        std::swap(p_out, p_other);
       }
-      auto iReadOut = this->state.iStoreOut + nDelayLine
-          - this->coeffs.osFactor * this->coeffs.osFirLenMult;
-      Stereo<signal_t> accum;
-      for (size_t i = 0; i < this->coeffs.osFactor * this->coeffs.osFirLenMult;
-          i++) {
-        accum += this->coeffs.b[i] * this->state.dlAntialiasing[iReadOut + i];
+    }
+
+    /**
+     * @brief Downsamples 'state.hi' through a cascade of 2x stages.
+     * @param stages Stages, from the base sample rate up
+     * @param y Output samples
+     * @param n Number of output samples
+     */
+    template <typename stages_t>
+    inline void _downsampleCascade(
+        stages_t& stages, Stereo<signal_t>* y, size_t n) noexcept {
+      const size_t nStages         = this->coeffs.nHalfBands;
+      const Stereo<signal_t>* p_in = this->state.hi.data();
+      size_t nOut                  = n << nStages;
+      for (size_t s = nStages; s-- > 0;) {
+        nOut /= 2;
+        auto p_out = s ? this->state.hiTmp.data() : y;
+        if (p_in == p_out) { p_out = this->state.hi.data(); }
+        stages[s].downBlock(p_in, p_out, nOut);
+        p_in = p_out;
       }
-      return accum;
     }
 
     /**
      * @brief Update coefficients based on current mode
      */
     inline void update() {
+      this->coeffs.nHalfBands   = 0;
+      this->coeffs.iir          = false;
+      this->coeffs.osFirLenMult = 1;
       switch (this->mode) {
-
-        // TODO: IIR oversampling
-        // case iir_2x:
-        //   this->coeffs.osFactor = 2;
-        //   break;
-        // case iir_4x:
-        //   this->coeffs.osFactor = 4;
-        //   break;
-        // case iir_8x:
-        //   this->coeffs.osFactor = 8;
-        //   break;
       case fir_2x_lq:
         this->coeffs.osFactor     = 2;
         this->coeffs.osFirLenMult = oversamplingFirMultLq;
@@ -230,6 +681,22 @@ namespace Src {
         this->coeffs.osFirLenMult = oversamplingFirMultHq;
         this->coeffs.disable      = false;
         break;
+      case hb_2x:
+      case hb_4x:
+      case hb_8x:
+      case hb_16x:
+        this->coeffs.nHalfBands = 1 + this->mode - hb_2x;
+        this->coeffs.osFactor   = size_t(1) << this->coeffs.nHalfBands;
+        this->coeffs.disable    = false;
+        break;
+      case iir_2x:
+      case iir_4x:
+      case iir_8x:
+        this->coeffs.nHalfBands = 1 + this->mode - iir_2x;
+        this->coeffs.osFactor   = size_t(1) << this->coeffs.nHalfBands;
+        this->coeffs.iir        = true;
+        this->coeffs.disable    = false;
+        break;
       default:
       case disable:
         this->coeffs.osFactor     = 1;
@@ -238,15 +705,57 @@ namespace Src {
       }
       this->coeffs.fsHi = this->fs * this->coeffs.osFactor;
       this->coeffs.n    = this->coeffs.osFactor * this->coeffs.osFirLenMult;
-      if (!this->coeffs.disable) {
+      for (size_t s = 0; s < this->coeffs.nHalfBands; s++) {
+        if (this->coeffs.iir) {
+          this->allpassHalfBands[s].reset(
+              allpassNCoeffs[s], allpassTransition[s]);
+        } else {
+          this->halfBands[s].reset(halfBandLen[s]);
+        }
+      }
+      this->coeffs.latency = 0;
+      for (size_t s = 0; s < this->coeffs.nHalfBands; s++) {
+        // Each stage runs at twice the rate of the previous one.
+        float latency = this->coeffs.iir
+            ? this->allpassHalfBands[s].getLatency()
+            : this->halfBands[s].getLatency();
+        this->coeffs.latency += latency / float(size_t(1) << s);
+      }
+      if (!this->coeffs.disable && !this->coeffs.nHalfBands) {
+        // Both filters delay by n / 2 samples at the high rate, and the
+        // output is taken at the last of osFactor high rate samples.
+        this->coeffs.latency = float(this->coeffs.osFirLenMult - 1);
         auto b = windowMethod<signal_t>(fc, this->coeffs.n, this->coeffs.fsHi);
         std::fill(this->coeffs.b.begin(), this->coeffs.b.end(), 0.0);
         for (size_t i = 0; i < this->coeffs.n; i++) {
           this->coeffs.b[i] = b[i];
         }
+        const size_t osFactor = this->coeffs.osFactor;
+        const size_t nTaps    = this->coeffs.osFirLenMult;
+        for (size_t i = 0; i < osFactor; i++) {
+          for (size_t j = 0; j < nTaps; j++) {
+            signal_t bj = this->coeffs.b[(nTaps - 1 - j) * osFactor + i]
+                * signal_t(osFactor);
+            this->coeffs.bUp[2 * (i * nTaps + j)]     = bj;
+            this->coeffs.bUp[2 * (i * nTaps + j) + 1] = bj;
+          }
+        }
+        for (size_t i = 0; i < this->coeffs.n; i++) {
+          this->coeffs.bDown[2 * i]     = this->coeffs.b[i];
+          this->coeffs.bDown[2 * i + 1] = this->coeffs.b[i];
+        }
       }
     }
 
+    /**
+     * @brief Total latency of the converter and the plugin.
+     * @return Latency in samples at the base sample rate
+     */
+    inline float getLatencySamples() const noexcept {
+      return this->coeffs.latency
+          + this->plug.getLatencySamples() / float(this->coeffs.osFactor);
+    }
+
     /**
      * @brief Reset the sample rate converter and change the sample rate.
      * @param fs Sampling rate
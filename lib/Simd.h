@@ -0,0 +1,609 @@
+#pragma once
+
+/**
+ * @file Simd.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Portable SIMD helpers for block processing of stereo signals.
+ * @details StereoVec holds the left and right channel of a Stereo<signal_t>
+ * in one register, which lets recursive filters run both channels with a
+ * single instruction stream. Since Stereo<signal_t> stores the channels next
+ * to each other, a whole frame is loaded and stored with a single instruction.
+ * SSE2 is used on x86, NEON on ARM and plain scalar code everywhere else.
+ * Stateless stages (gain, soft clipping) are written as simple loops over
+ * frames, which compilers vectorize to the full register width. Peak meters
+ * are reductions, which compilers do not vectorize without fast math, so
+ * reducePeak() is written out per backend. FrameVec holds as many frames as
+ * fit in a register and lets Biquad::Bank run several bands at once.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lib/Stereo.h"
+#include <cstddef>
+#include <type_traits>
+
+#if defined(NTFX_SIMD_DISABLE)
+  // Scalar fallback only.
+#elif defined(__SSE2__) || defined(_M_X64)                                     \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define NTFX_SIMD_SSE2
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+  #define NTFX_SIMD_NEON
+  #include <arm_neon.h>
+  #if defined(__aarch64__) || defined(_M_ARM64)
+    #define NTFX_SIMD_NEON64
+  #endif
+#endif
+
+namespace NtFx {
+namespace Simd {
+  static_assert(sizeof(Stereo<float>) == 2 * sizeof(float),
+      "Stereo<float> must be two packed floats.");
+  static_assert(sizeof(Stereo<double>) == 2 * sizeof(double),
+      "Stereo<double> must be two packed doubles.");
+
+  /**
+   * @brief Left and right channel in a single register. Scalar fallback used
+   * when no SIMD backend is available for signal_t.
+   *
+   * @tparam signal_t Audio datatype.
+   */
+  template <typename signal_t>
+  struct StereoVec {
+    signal_t l;
+    signal_t r;
+    static inline StereoVec load(const Stereo<signal_t>* p) noexcept {
+      return { p->l, p->r };
+    }
+    static inline StereoVec set(signal_t l, signal_t r) noexcept {
+      return { l, r };
+    }
+    static inline StereoVec splat(signal_t x) noexcept { return { x, x }; }
+    inline void store(Stereo<signal_t>* p) const noexcept {
+      p->l = this->l;
+      p->r = this->r;
+    }
+    inline Stereo<signal_t> toStereo() const noexcept {
+      return { this->l, this->r };
+    }
+    friend inline StereoVec operator+(StereoVec a, StereoVec b) noexcept {
+      return { a.l + b.l, a.r + b.r };
+    }
+    friend inline StereoVec operator-(StereoVec a, StereoVec b) noexcept {
+      return { a.l - b.l, a.r - b.r };
+    }
+    friend inline StereoVec operator*(StereoVec a, StereoVec b) noexcept {
+      return { a.l * b.l, a.r * b.r };
+    }
+    friend inline StereoVec operator/(StereoVec a, StereoVec b) noexcept {
+      return { a.l / b.l, a.r / b.r };
+    }
+  };
+
+#if defined(NTFX_SIMD_SSE2)
+  template <>
+  struct StereoVec<float> {
+    __m128 v; ///< Left and right in the two lowest lanes.
+    static inline StereoVec load(const Stereo<float>* p) noexcept {
+      return { _mm_castpd_ps(
+          _mm_load_sd(reinterpret_cast<const double*>(p))) };
+    }
+    static inline StereoVec set(float l, float r) noexcept {
+      return { _mm_setr_ps(l, r, 0.0f, 0.0f) };
+    }
+    static inline StereoVec splat(float x) noexcept {
+      return { _mm_set1_ps(x) };
+    }
+    inline void store(Stereo<float>* p) const noexcept {
+      _mm_store_sd(reinterpret_cast<double*>(p), _mm_castps_pd(this->v));
+    }
+    inline Stereo<float> toStereo() const noexcept {
+      Stereo<float> y;
+      this->store(&y);
+      return y;
+    }
+    friend inline StereoVec operator+(StereoVec a, StereoVec b) noexcept {
+      return { _mm_add_ps(a.v, b.v) };
+    }
+    friend inline StereoVec operator-(StereoVec a, StereoVec b) noexcept {
+      return { _mm_sub_ps(a.v, b.v) };
+    }
+    friend inline StereoVec operator*(StereoVec a, StereoVec b) noexcept {
+      return { _mm_mul_ps(a.v, b.v) };
+    }
+    friend inline StereoVec operator/(StereoVec a, StereoVec b) noexcept {
+      return { _mm_div_ps(a.v, b.v) };
+    }
+  };
+
+  template <>
+  struct StereoVec<double> {
+    __m128d v;
+    static inline StereoVec load(const Stereo<double>* p) noexcept {
+      return { _mm_loadu_pd(reinterpret_cast<const double*>(p)) };
+    }
+    static inline StereoVec set(double l, double r) noexcept {
+      return { _mm_setr_pd(l, r) };
+    }
+    static inline StereoVec splat(double x) noexcept {
+      return { _mm_set1_pd(x) };
+    }
+    inline void store(Stereo<double>* p) const noexcept {
+      _mm_storeu_pd(reinterpret_cast<double*>(p), this->v);
+    }
+    inline Stereo<double> toStereo() const noexcept {
+      Stereo<double> y;
+      this->store(&y);
+      return y;
+    }
+    friend inline StereoVec operator+(StereoVec a, StereoVec b) noexcept {
+      return { _mm_add_pd(a.v, b.v) };
+    }
+    friend inline StereoVec operator-(StereoVec a, StereoVec b) noexcept {
+      return { _mm_sub_pd(a.v, b.v) };
+    }
+    friend inline StereoVec operator*(StereoVec a, StereoVec b) noexcept {
+      return { _mm_mul_pd(a.v, b.v) };
+    }
+    friend inline StereoVec operator/(StereoVec a, StereoVec b) noexcept {
+      return { _mm_div_pd(a.v, b.v) };
+    }
+  };
+#elif defined(NTFX_SIMD_NEON)
+  template <>
+  struct StereoVec<float> {
+    float32x2_t v;
+    static inline StereoVec load(const Stereo<float>* p) noexcept {
+      return { vld1_f32(reinterpret_cast<const float*>(p)) };
+    }
+    static inline StereoVec set(float l, float r) noexcept {
+      const float tmp[2] = { l, r };
+      return { vld1_f32(tmp) };
+    }
+    static inline StereoVec splat(float x) noexcept {
+      return { vdup_n_f32(x) };
+    }
+    inline void store(Stereo<float>* p) const noexcept {
+      vst1_f32(reinterpret_cast<float*>(p), this->v);
+    }
+    inline Stereo<float> toStereo() const noexcept {
+      Stereo<float> y;
+      this->store(&y);
+      return y;
+    }
+    friend inline StereoVec operator+(StereoVec a, StereoVec b) noexcept {
+      return { vadd_f32(a.v, b.v) };
+    }
+    friend inline StereoVec operator-(StereoVec a, StereoVec b) noexcept {
+      return { vsub_f32(a.v, b.v) };
+    }
+    friend inline StereoVec operator*(StereoVec a, StereoVec b) noexcept {
+      return { vmul_f32(a.v, b.v) };
+    }
+    friend inline StereoVec operator/(StereoVec a, StereoVec b) noexcept {
+    #if defined(NTFX_SIMD_NEON64)
+      return { vdiv_f32(a.v, b.v) };
+    #else
+      return set(vget_lane_f32(a.v, 0) / vget_lane_f32(b.v, 0),
+          vget_lane_f32(a.v, 1) / vget_lane_f32(b.v, 1));
+    #endif
+    }
+  };
+
+  #if defined(NTFX_SIMD_NEON64)
+  template <>
+  struct StereoVec<double> {
+    float64x2_t v;
+    static inline StereoVec load(const Stereo<double>* p) noexcept {
+      return { vld1q_f64(reinterpret_cast<const double*>(p)) };
+    }
+    static inline StereoVec set(double l, double r) noexcept {
+      const double tmp[2] = { l, r };
+      return { vld1q_f64(tmp) };
+    }
+    static inline StereoVec splat(double x) noexcept {
+      return { vdupq_n_f64(x) };
+    }
+    inline void store(Stereo<double>* p) const noexcept {
+      vst1q_f64(reinterpret_cast<double*>(p), this->v);
+    }
+    inline Stereo<double> toStereo() const noexcept {
+      Stereo<double> y;
+      this->store(&y);
+      return y;
+    }
+    friend inline StereoVec operator+(StereoVec a, StereoVec b) noexcept {
+      return { vaddq_f64(a.v, b.v) };
+    }
+    friend inline StereoVec operator-(StereoVec a, StereoVec b) noexcept {
+      return { vsubq_f64(a.v, b.v) };
+    }
+    friend inline StereoVec operator*(StereoVec a, StereoVec b) noexcept {
+      return { vmulq_f64(a.v, b.v) };
+    }
+    friend inline StereoVec operator/(StereoVec a, StereoVec b) noexcept {
+      return { vdivq_f64(a.v, b.v) };
+    }
+  };
+  #endif
+#endif
+
+  /**
+   * @brief As many stereo frames as fit in a single register, 'nFrames' of
+   * them. Lets a bank of filter sections run one section per frame. Falls back
+   * to a single StereoVec when there is no wider register for signal_t.
+   *
+   * @tparam signal_t Audio datatype.
+   */
+  template <typename signal_t>
+  struct FrameVec {
+    static constexpr size_t nFrames = 1;
+    using mask_t                    = bool; ///< Frames selected by select().
+    StereoVec<signal_t> v;
+    static inline FrameVec load(const Stereo<signal_t>* p) noexcept {
+      return { StereoVec<signal_t>::load(p) };
+    }
+    static inline FrameVec splat(Stereo<signal_t> x) noexcept {
+      return { StereoVec<signal_t>::set(x.l, x.r) };
+    }
+    /** Last frame of 'prev' followed by all but the last frame of 'cur'. */
+    static inline FrameVec shift(FrameVec prev, FrameVec) noexcept {
+      return prev;
+    }
+    /** Mask from one flag per frame. */
+    static inline mask_t mask(const bool* active) noexcept {
+      return active[0];
+    }
+    /** Frames of 'a' where 'm' is set and of 'b' elsewhere. */
+    static inline FrameVec select(mask_t m, FrameVec a, FrameVec b) noexcept {
+      return m ? a : b;
+    }
+    inline void store(Stereo<signal_t>* p) const noexcept { this->v.store(p); }
+    inline Stereo<signal_t> sum() const noexcept { return this->v.toStereo(); }
+    inline Stereo<signal_t> last() const noexcept {
+      return this->v.toStereo();
+    }
+    friend inline FrameVec operator+(FrameVec a, FrameVec b) noexcept {
+      return { a.v + b.v };
+    }
+    friend inline FrameVec operator-(FrameVec a, FrameVec b) noexcept {
+      return { a.v - b.v };
+    }
+    friend inline FrameVec operator*(FrameVec a, FrameVec b) noexcept {
+      return { a.v * b.v };
+    }
+  };
+
+#if defined(NTFX_SIMD_SSE2)
+  template <>
+  struct FrameVec<float> {
+    static constexpr size_t nFrames = 2;
+    using mask_t                    = __m128;
+    __m128 v;
+    static inline FrameVec load(const Stereo<float>* p) noexcept {
+      return { _mm_loadu_ps(reinterpret_cast<const float*>(p)) };
+    }
+    static inline FrameVec splat(Stereo<float> x) noexcept {
+      return { _mm_setr_ps(x.l, x.r, x.l, x.r) };
+    }
+    static inline FrameVec shift(FrameVec prev, FrameVec cur) noexcept {
+      return { _mm_shuffle_ps(prev.v, cur.v, _MM_SHUFFLE(1, 0, 3, 2)) };
+    }
+    static inline mask_t mask(const bool* active) noexcept {
+      const int f0 = active[0] ? -1 : 0;
+      const int f1 = active[1] ? -1 : 0;
+      return _mm_castsi128_ps(_mm_setr_epi32(f0, f0, f1, f1));
+    }
+    static inline FrameVec select(mask_t m, FrameVec a, FrameVec b) noexcept {
+      return { _mm_or_ps(_mm_and_ps(m, a.v), _mm_andnot_ps(m, b.v)) };
+    }
+    inline void store(Stereo<float>* p) const noexcept {
+      _mm_storeu_ps(reinterpret_cast<float*>(p), this->v);
+    }
+    inline Stereo<float> sum() const noexcept {
+      const auto frames = _mm_add_ps(this->v, _mm_movehl_ps(this->v, this->v));
+      return StereoVec<float> { frames }.toStereo();
+    }
+    inline Stereo<float> last() const noexcept {
+      return StereoVec<float> { _mm_movehl_ps(this->v, this->v) }.toStereo();
+    }
+    friend inline FrameVec operator+(FrameVec a, FrameVec b) noexcept {
+      return { _mm_add_ps(a.v, b.v) };
+    }
+    friend inline FrameVec operator-(FrameVec a, FrameVec b) noexcept {
+      return { _mm_sub_ps(a.v, b.v) };
+    }
+    friend inline FrameVec operator*(FrameVec a, FrameVec b) noexcept {
+      return { _mm_mul_ps(a.v, b.v) };
+    }
+  };
+#elif defined(NTFX_SIMD_NEON)
+  template <>
+  struct FrameVec<float> {
+    static constexpr size_t nFrames = 2;
+    using mask_t                    = uint32x4_t;
+    float32x4_t v;
+    static inline FrameVec load(const Stereo<float>* p) noexcept {
+      return { vld1q_f32(reinterpret_cast<const float*>(p)) };
+    }
+    static inline FrameVec splat(Stereo<float> x) noexcept {
+      const auto frame = StereoVec<float>::set(x.l, x.r).v;
+      return { vcombine_f32(frame, frame) };
+    }
+    static inline FrameVec shift(FrameVec prev, FrameVec cur) noexcept {
+      return { vextq_f32(prev.v, cur.v, 2) };
+    }
+    static inline mask_t mask(const bool* active) noexcept {
+      const uint32_t f0  = active[0] ? ~0u : 0u;
+      const uint32_t f1  = active[1] ? ~0u : 0u;
+      const uint32_t m[] = { f0, f0, f1, f1 };
+      return vld1q_u32(m);
+    }
+    static inline FrameVec select(mask_t m, FrameVec a, FrameVec b) noexcept {
+      return { vbslq_f32(m, a.v, b.v) };
+    }
+    inline void store(Stereo<float>* p) const noexcept {
+      vst1q_f32(reinterpret_cast<float*>(p), this->v);
+    }
+    inline Stereo<float> sum() const noexcept {
+      const auto frames
+          = vadd_f32(vget_low_f32(this->v), vget_high_f32(this->v));
+      return StereoVec<float> { frames }.toStereo();
+    }
+    inline Stereo<float> last() const noexcept {
+      return StereoVec<float> { vget_high_f32(this->v) }.toStereo();
+    }
+    friend inline FrameVec operator+(FrameVec a, FrameVec b) noexcept {
+      return { vaddq_f32(a.v, b.v) };
+    }
+    friend inline FrameVec operator-(FrameVec a, FrameVec b) noexcept {
+      return { vsubq_f32(a.v, b.v) };
+    }
+    friend inline FrameVec operator*(FrameVec a, FrameVec b) noexcept {
+      return { vmulq_f32(a.v, b.v) };
+    }
+  };
+#endif
+
+  /**
+   * @brief Dot product of a coefficient vector and a run of stereo frames, as
+   * used by FIR filters. The coefficients are stored twice, c[2 * j] ==
+   * c[2 * j + 1], so a register of frames is multiplied by a register of
+   * coefficients directly and two frames are processed per instruction for
+   * float.
+   *
+   * @tparam signal_t Audio datatype.
+   * @param c Duplicated coefficients. Length 2 * n.
+   * @param x Frames. Length n.
+   * @param n Number of taps.
+   * @return Stereo<signal_t> Sum of c[2 * j] * x[j].
+   */
+  template <typename signal_t>
+  static inline Stereo<signal_t> dotStereo(
+      const signal_t* c, const Stereo<signal_t>* x, size_t n) noexcept {
+    size_t j = 0;
+    auto acc = StereoVec<signal_t>::splat(0);
+#if defined(NTFX_SIMD_SSE2)
+    if constexpr (std::is_same_v<signal_t, float>) {
+      auto p_x  = reinterpret_cast<const float*>(x);
+      auto acc0 = _mm_setzero_ps();
+      auto acc1 = _mm_setzero_ps();
+      for (; j + 4 <= n; j += 4) {
+        acc0 = _mm_add_ps(acc0,
+            _mm_mul_ps(_mm_loadu_ps(c + 2 * j), _mm_loadu_ps(p_x + 2 * j)));
+        acc1 = _mm_add_ps(acc1,
+            _mm_mul_ps(
+                _mm_loadu_ps(c + 2 * j + 4), _mm_loadu_ps(p_x + 2 * j + 4)));
+      }
+      acc0  = _mm_add_ps(acc0, acc1);
+      acc.v = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+    }
+#elif defined(NTFX_SIMD_NEON)
+    if constexpr (std::is_same_v<signal_t, float>) {
+      auto p_x  = reinterpret_cast<const float*>(x);
+      auto acc0 = vdupq_n_f32(0);
+      auto acc1 = vdupq_n_f32(0);
+      for (; j + 4 <= n; j += 4) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(c + 2 * j), vld1q_f32(p_x + 2 * j));
+        acc1 = vmlaq_f32(
+            acc1, vld1q_f32(c + 2 * j + 4), vld1q_f32(p_x + 2 * j + 4));
+      }
+      acc0  = vaddq_f32(acc0, acc1);
+      acc.v = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+    }
+#endif
+    for (; j < n; j++) {
+      acc = acc
+          + StereoVec<signal_t>::splat(c[2 * j])
+              * StereoVec<signal_t>::load(x + j);
+    }
+    return acc.toStereo();
+  }
+
+  /**
+   * @brief Interleaves two planar channels into stereo frames.
+   *
+   * @tparam signal_t Audio datatype.
+   * @param l Left channel.
+   * @param r Right channel.
+   * @param y Output frames.
+   * @param n Number of samples.
+   */
+  template <typename signal_t>
+  static inline void interleave(const signal_t* l,
+      const signal_t* r,
+      Stereo<signal_t>* y,
+      size_t n) noexcept {
+    size_t i = 0;
+#if defined(NTFX_SIMD_SSE2)
+    if constexpr (std::is_same_v<signal_t, float>) {
+      auto p_y = reinterpret_cast<float*>(y);
+      for (; i + 4 <= n; i += 4) {
+        auto _l = _mm_loadu_ps(l + i);
+        auto _r = _mm_loadu_ps(r + i);
+        _mm_storeu_ps(p_y + 2 * i, _mm_unpacklo_ps(_l, _r));
+        _mm_storeu_ps(p_y + 2 * i + 4, _mm_unpackhi_ps(_l, _r));
+      }
+    }
+#elif defined(NTFX_SIMD_NEON)
+    if constexpr (std::is_same_v<signal_t, float>) {
+      auto p_y = reinterpret_cast<float*>(y);
+      for (; i + 4 <= n; i += 4) {
+        vst2q_f32(p_y + 2 * i,
+            float32x4x2_t { vld1q_f32(l + i), vld1q_f32(r + i) });
+      }
+    }
+#endif
+    for (; i < n; i++) { y[i] = { l[i], r[i] }; }
+  }
+
+  /**
+   * @brief Splits stereo frames into two planar channels.
+   *
+   * @tparam signal_t Audio datatype.
+   * @param x Input frames.
+   * @param l Left channel.
+   * @param r Right channel.
+   * @param n Number of samples.
+   */
+  template <typename signal_t>
+  static inline void deinterleave(const Stereo<signal_t>* x,
+      signal_t* l,
+      signal_t* r,
+      size_t n) noexcept {
+    size_t i = 0;
+#if defined(NTFX_SIMD_SSE2)
+    if constexpr (std::is_same_v<signal_t, float>) {
+      auto p_x = reinterpret_cast<const float*>(x);
+      for (; i + 4 <= n; i += 4) {
+        auto a = _mm_loadu_ps(p_x + 2 * i);
+        auto b = _mm_loadu_ps(p_x + 2 * i + 4);
+        _mm_storeu_ps(l + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(r + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+      }
+    }
+#elif defined(NTFX_SIMD_NEON)
+    if constexpr (std::is_same_v<signal_t, float>) {
+      auto p_x = reinterpret_cast<const float*>(x);
+      for (; i + 4 <= n; i += 4) {
+        auto lr = vld2q_f32(p_x + 2 * i);
+        vst1q_f32(l + i, lr.val[0]);
+        vst1q_f32(r + i, lr.val[1]);
+      }
+    }
+#endif
+    for (; i < n; i++) {
+      l[i] = x[i].l;
+      r[i] = x[i].r;
+    }
+  }
+
+  /**
+   * @brief Multiplies a block of frames by a stereo gain.
+   *
+   * @tparam signal_t Audio datatype.
+   * @param x Input frames.
+   * @param y Output frames. May be the same buffer as 'x'.
+   * @param n Number of samples.
+   * @param gain Linear gain for left and right.
+   */
+  template <typename signal_t>
+  static inline void applyGain(const Stereo<signal_t>* x,
+      Stereo<signal_t>* y,
+      size_t n,
+      Stereo<signal_t> gain) noexcept {
+    const auto g = StereoVec<signal_t>::set(gain.l, gain.r);
+    for (size_t i = 0; i < n; i++) {
+      (StereoVec<signal_t>::load(x + i) * g).store(y + i);
+    }
+  }
+
+  /**
+   * @brief Folds the magnitude of a block of frames into a peak level, per
+   * channel, as used by meters. The largest magnitude is kept, or the
+   * smallest for inverted meters such as gain reduction. NaNs are skipped.
+   *
+   * @tparam invert Keep the smallest magnitude instead of the largest.
+   * @tparam signal_t Audio datatype.
+   * @param x Frames.
+   * @param n Number of frames.
+   * @param peak Peak level so far.
+   * @return Stereo<signal_t> New peak level.
+   */
+  template <bool invert, typename signal_t>
+  static inline Stereo<signal_t> reducePeak(
+      const Stereo<signal_t>* x, size_t n, Stereo<signal_t> peak) noexcept {
+    size_t i = 0;
+#if defined(NTFX_SIMD_SSE2)
+    // The max and min instructions return the second operand if either is a
+    // NaN, so the peak goes second.
+    if constexpr (std::is_same_v<signal_t, float>) {
+      auto fold = [](__m128 a, __m128 b) {
+        if constexpr (invert) { return _mm_min_ps(a, b); }
+        return _mm_max_ps(a, b);
+      };
+      const auto mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+      auto p_x        = reinterpret_cast<const float*>(x);
+      auto acc0       = _mm_setr_ps(peak.l, peak.r, peak.l, peak.r);
+      auto acc1       = acc0;
+      for (; i + 4 <= n; i += 4) {
+        acc0 = fold(_mm_and_ps(_mm_loadu_ps(p_x + 2 * i), mask), acc0);
+        acc1 = fold(_mm_and_ps(_mm_loadu_ps(p_x + 2 * i + 4), mask), acc1);
+      }
+      acc0 = fold(acc0, acc1);
+      peak = StereoVec<float> { fold(acc0, _mm_movehl_ps(acc0, acc0)) }
+                 .toStereo();
+    } else if constexpr (std::is_same_v<signal_t, double>) {
+      const auto mask
+          = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+      auto acc = StereoVec<double>::set(peak.l, peak.r).v;
+      for (; i < n; i++) {
+        auto a = _mm_and_pd(StereoVec<double>::load(x + i).v, mask);
+        acc    = invert ? _mm_min_pd(a, acc) : _mm_max_pd(a, acc);
+      }
+      peak = StereoVec<double> { acc }.toStereo();
+    }
+#elif defined(NTFX_SIMD_NEON64)
+    // The 'nm' variants return the number if one operand is a NaN.
+    if constexpr (std::is_same_v<signal_t, float>) {
+      auto fold = [](float32x4_t a, float32x4_t b) {
+        if constexpr (invert) { return vminnmq_f32(a, b); }
+        return vmaxnmq_f32(a, b);
+      };
+      auto p_x  = reinterpret_cast<const float*>(x);
+      auto p    = StereoVec<float>::set(peak.l, peak.r).v;
+      auto acc0 = vcombine_f32(p, p);
+      auto acc1 = acc0;
+      for (; i + 4 <= n; i += 4) {
+        acc0 = fold(vabsq_f32(vld1q_f32(p_x + 2 * i)), acc0);
+        acc1 = fold(vabsq_f32(vld1q_f32(p_x + 2 * i + 4)), acc1);
+      }
+      acc0 = fold(acc0, acc1);
+      acc0 = fold(acc0, vcombine_f32(vget_high_f32(acc0), p));
+      peak = StereoVec<float> { vget_low_f32(acc0) }.toStereo();
+    }
+#endif
+    for (; i < n; i++) {
+      const signal_t l = x[i].l < 0 ? -x[i].l : x[i].l;
+      const signal_t r = x[i].r < 0 ? -x[i].r : x[i].r;
+      if (invert ? l < peak.l : l > peak.l) { peak.l = l; }
+      if (invert ? r < peak.r : r > peak.r) { peak.r = r; }
+    }
+    return peak;
+  }
+} // namespace Simd
+} // namespace NtFx
@@ -0,0 +1,176 @@
+#pragma once
+
+/**
+ * @file SlidingMax.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Maximum over a sliding window in constant amortized time.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lib/Component.h"
+#include "lib/Stereo.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace NtFx {
+
+/**
+ * @brief Maximum of the last 'nWindow' input samples. The candidates for the
+ * maximum are kept in a monotonic deque: a new sample removes all older
+ * samples that are not larger than itself, since those can never be the
+ * maximum again, and the oldest sample leaves when it falls out of the window.
+ * Every sample enters and leaves once, so the cost per sample is constant on
+ * average, however long the window.
+ *
+ * The deque is a ring buffer allocated in reset() from 'maxT_ms' and the
+ * sample rate. Call reset() before processing and not from the audio thread.
+ * For peak detection, feed it the absolute value of the signal.
+ *
+ * @tparam signal_t Audio datatype.
+ */
+template <typename signal_t>
+struct SlidingMax final : public Component<signal_t> {
+  signal_t maxT_ms { 10 }; ///< Longest window. Used by reset().
+  signal_t t_ms { 0 };     ///< Window length in ms. 0 gives the input.
+  std::vector<signal_t> vals; ///< Candidates, decreasing from head to tail.
+  std::vector<size_t> idxs;   ///< Sample index of each candidate.
+  size_t mask { 0 };
+  size_t head { 0 };    ///< Oldest candidate.
+  size_t tail { 0 };    ///< One past the newest candidate.
+  size_t idx { 0 };     ///< Index of the next sample.
+  size_t nWindow { 1 }; ///< Window length in samples, including the newest.
+
+  /**
+   * @brief Adds a sample and returns the maximum of the window.
+   *
+   * @param x Input.
+   * @return signal_t Largest of the last 'nWindow' samples.
+   */
+  virtual signal_t process(signal_t x) noexcept override {
+    if (this->vals.empty()) { return x; }
+    // Expire first, so the deque never holds more than 'nWindow' samples.
+    while (this->head != this->tail
+        && this->idx - this->idxs[this->head & this->mask] >= this->nWindow) {
+      this->head++;
+    }
+    while (this->tail != this->head
+        && this->vals[(this->tail - 1) & this->mask] <= x) {
+      this->tail--;
+    }
+    this->vals[this->tail & this->mask] = x;
+    this->idxs[this->tail & this->mask] = this->idx;
+    this->tail++;
+    this->idx++;
+    return this->vals[this->head & this->mask];
+  }
+
+  virtual void processBlock(
+      const signal_t* x, signal_t* y, size_t n) noexcept override {
+    for (size_t i = 0; i < n; i++) { y[i] = this->process(x[i]); }
+  }
+
+  /**
+   * @brief Sets the window length from 't_ms'. Samples already in the window
+   * are kept, so the window can be changed while running.
+   */
+  virtual void update() noexcept override {
+    this->setWindowSamples(this->getWindowSamples(this->t_ms));
+  }
+
+  /**
+   * @brief Sets the window length in samples directly, bypassing 't_ms'. The
+   * length is limited to the allocated size.
+   *
+   * @param n Window length, including the newest sample.
+   */
+  void setWindowSamples(size_t n) noexcept {
+    this->nWindow = std::max(n, size_t(1));
+    if (!this->vals.empty()) {
+      this->nWindow = std::min(this->nWindow, this->vals.size());
+    }
+  }
+
+  /**
+   * @brief Allocates and clears the deque.
+   *
+   * @param fs Sample rate.
+   */
+  virtual void reset(float fs) noexcept override {
+    this->fs      = fs;
+    size_t len    = this->getWindowSamples(this->maxT_ms);
+    size_t lenPow = 1;
+    while (lenPow < len) { lenPow *= 2; }
+    this->vals.assign(lenPow, signal_t(0));
+    this->idxs.assign(lenPow, 0);
+    this->mask = lenPow - 1;
+    this->head = 0;
+    this->tail = 0;
+    this->idx  = 0;
+    this->update();
+  }
+
+  /**
+   * @brief Window length in samples for a window of 't_ms', including the
+   * newest sample.
+   */
+  size_t getWindowSamples(signal_t t_ms) const noexcept {
+    if (!(t_ms > 0)) { return 1; }
+    return size_t(std::lround(t_ms * this->fs / 1000)) + 1;
+  }
+};
+
+/**
+ * @brief Stereo version of SlidingMax.
+ *
+ * @tparam signal_t Audio datatype.
+ */
+template <typename signal_t>
+struct SlidingMaxStereo
+    : public StereoComponent<signal_t, SlidingMax<signal_t>> {
+  /**
+   * @brief Sets the window length of both channels.
+   *
+   * @param t_ms Window length in ms.
+   */
+  void setT_ms(signal_t t_ms) {
+    this->l.t_ms = t_ms;
+    this->r.t_ms = t_ms;
+  }
+
+  /**
+   * @brief Sets the window length of both channels in samples.
+   *
+   * @param n Window length, including the newest sample.
+   */
+  void setWindowSamples(size_t n) noexcept {
+    this->l.setWindowSamples(n);
+    this->r.setWindowSamples(n);
+  }
+
+  /**
+   * @brief Sets the longest window of both channels. Takes effect on reset().
+   *
+   * @param maxT_ms Longest window in ms.
+   */
+  void setMaxT_ms(signal_t maxT_ms) {
+    this->l.maxT_ms = maxT_ms;
+    this->r.maxT_ms = maxT_ms;
+  }
+};
+}
@@ -24,6 +24,7 @@
 
 #include "lib/Component.h"
 #include "lib/Stereo.h"
+#include <algorithm>
 #include <array>
 
 namespace NtFx {
@@ -34,10 +35,15 @@ namespace NtFx {
  * @tparam signal_t Audio datatype.
  */
 template <typename signal_t>
-class SoftClip3 : public Component<Stereo<signal_t>> {
+class SoftClip3 final : public Component<Stereo<signal_t>> {
   virtual Stereo<signal_t> process(Stereo<signal_t> x) noexcept override {
     return softClip3rdStereo(x);
   }
+  virtual void processBlock(const Stereo<signal_t>* x,
+      Stereo<signal_t>* y,
+      size_t n) noexcept override {
+    for (size_t i = 0; i < n; i++) { y[i] = softClip3rdStereo(x[i]); }
+  }
 };
 
 /**
@@ -46,10 +52,15 @@ class SoftClip3 : public Component<Stereo<signal_t>> {
  * @tparam signal_t Audio datatype.
  */
 template <typename signal_t>
-class SoftClip5 : public Component<Stereo<signal_t>> {
+class SoftClip5 final : public Component<Stereo<signal_t>> {
   virtual Stereo<signal_t> process(Stereo<signal_t> x) noexcept override {
     return softClip5thStereo(x);
   }
+  virtual void processBlock(const Stereo<signal_t>* x,
+      Stereo<signal_t>* y,
+      size_t n) noexcept override {
+    for (size_t i = 0; i < n; i++) { y[i] = softClip5thStereo(x[i]); }
+  }
 };
 
 /**
@@ -93,12 +104,14 @@ constexpr std::array<signal_t, 2> _coeffsThird =
  */
 template <typename signal_t>
 static inline signal_t softClip5thMono(signal_t x) noexcept {
-  signal_t x_ = x / _coeffsFifth<signal_t>[0];
-  if (x_ > 1.0) { return signal_t(1.0); }
-  if (x_ < -1.0) { return signal_t(-1.0); }
-  auto x3 = x_ * x_ * x_;
-  auto x5 = x3 * x_ * x_;
-  return x + _coeffsFifth<signal_t>[1] * x3 + _coeffsFifth<signal_t>[2] * x5;
+  // Clamping instead of branching keeps block loops vectorizable. The
+  // coefficients sum to one, so the polynomial is 1 at the clamp.
+  constexpr signal_t a0 = _coeffsFifth<signal_t>[0];
+  signal_t xc           = std::clamp(x, -a0, a0);
+  signal_t x_           = xc / a0;
+  auto x3               = x_ * x_ * x_;
+  auto x5               = x3 * x_ * x_;
+  return xc + _coeffsFifth<signal_t>[1] * x3 + _coeffsFifth<signal_t>[2] * x5;
 }
 
 /**
@@ -122,12 +135,13 @@ static inline Stereo<signal_t> softClip5thStereo(Stereo<signal_t> x) noexcept {
  * @return signal_t Output sample.
  */
 template <typename signal_t>
-static inline signal_t softClip3rdMono(signal_t x) {
-  if (x > 1.0) { return signal_t(1.0); }
-  if (x < -1.0) { return signal_t(-1.0); }
-  auto x_ = x / _coeffsThird<signal_t>[0];
-  auto x3 = x_ * x_ * x_;
-  return x - _coeffsThird<signal_t>[1] * x3;
+static inline signal_t softClip3rdMono(signal_t x) noexcept {
+  // Select instead of branch to keep block loops vectorizable.
+  signal_t xc = std::clamp(x, signal_t(-1.0), signal_t(1.0));
+  auto x_     = xc / _coeffsThird<signal_t>[0];
+  auto x3     = x_ * x_ * x_;
+  auto y      = xc - _coeffsThird<signal_t>[1] * x3;
+  return xc == x ? y : xc;
 }
 
 /**
@@ -139,7 +153,8 @@ static inline signal_t softClip3rdMono(signal_t x) {
  * @return signal_t Output sample.
  */
 template <typename signal_t>
-static inline signal_t softClip3rdStereo(signal_t x) {
+static inline Stereo<signal_t> softClip3rdStereo(
+    Stereo<signal_t> x) noexcept {
   return { softClip3rdMono(x.l), softClip3rdMono(x.r) };
 }
 } // namespace NtFx
@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * @file SpscQueue.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Lock-free queue for passing data between two threads.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace NtFx {
+
+/**
+ * @brief Wait-free ring buffer with a single producer thread and a single
+ * consumer thread, e.g. the UI and the audio thread. Neither side ever blocks
+ * or allocates. Copying a queue gives an empty queue, since the contents
+ * belong to the threads using the original.
+ *
+ * @tparam T Element type.
+ * @tparam N Capacity. Must be a power of two.
+ */
+template <typename T, size_t N>
+struct SpscQueue {
+  static_assert(N && !(N & (N - 1)), "Capacity must be a power of two.");
+
+  std::array<T, N> buffer;
+  alignas(64) std::atomic<size_t> head { 0 }; ///< Read count. Consumer owned.
+  alignas(64) std::atomic<size_t> tail { 0 }; ///< Write count. Producer owned.
+
+  SpscQueue() = default;
+  SpscQueue(const SpscQueue&) { }
+  SpscQueue& operator=(const SpscQueue&) noexcept { return *this; }
+
+  /**
+   * @brief Adds an element. Call from the producer thread only.
+   *
+   * @param x Element to add.
+   * @return true if added, false if the queue is full.
+   */
+  bool push(const T& x) noexcept {
+    const size_t t = this->tail.load(std::memory_order_relaxed);
+    if (t - this->head.load(std::memory_order_acquire) >= N) { return false; }
+    this->buffer[t & (N - 1)] = x;
+    this->tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Removes the oldest element. Call from the consumer thread only.
+   *
+   * @param x Destination of the element.
+   * @return true if an element was removed, false if the queue is empty.
+   */
+  bool pop(T& x) noexcept {
+    const size_t h = this->head.load(std::memory_order_relaxed);
+    if (h == this->tail.load(std::memory_order_acquire)) { return false; }
+    x = this->buffer[h & (N - 1)];
+    this->head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Checks if the queue is empty. Exact on the consumer thread.
+   */
+  bool empty() const noexcept {
+    return this->head.load(std::memory_order_acquire)
+        == this->tail.load(std::memory_order_acquire);
+  }
+};
+}
@@ -24,6 +24,7 @@
 #include "gcem.hpp"
 #include "gcem_incl/abs.hpp"
 #include "lib/utils.h"
+#include <cmath>
 #include <cstddef>
 #include <type_traits>
 
@@ -123,7 +124,7 @@ struct Stereo {
    * @return signal_t
    */
   signal_t absMax() const noexcept {
-    return gcem::abs(this->l) > gcem::abs(this->r) ? this->l : this->r;
+    return std::abs(this->l) > std::abs(this->r) ? this->l : this->r;
   }
 
   /**
@@ -132,7 +133,7 @@ struct Stereo {
    * @return signal_t
    */
   signal_t absMin() const noexcept {
-    return gcem::abs(this->l) < gcem::abs(this->r) ? this->l : this->r;
+    return std::abs(this->l) < std::abs(this->r) ? this->l : this->r;
   }
 
   /**
@@ -141,7 +142,7 @@ struct Stereo {
    * @return Stereo<signal_t>
    */
   Stereo<signal_t> abs() const noexcept {
-    return { gcem::abs(this->l), gcem::abs(this->r) };
+    return { std::abs(this->l), std::abs(this->r) };
   }
 };
 template <typename signal_t>
@@ -0,0 +1,239 @@
+#pragma once
+
+/**
+ * @file TestVector.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Reading and writing of stereo test vectors for ComponentTest.
+ * @details Vectors are stored as raw little endian float64, interleaved left
+ * and right, after a 24 byte header. Binary files are memory mapped on read,
+ * so loading a vector costs no more than copying it. The old format, two
+ * columns of text, is still read and is converted to binary on first use.
+ * 'testWrapper/test.py' reads and writes the same format.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lib/Stereo.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+  #define NTFX_TEST_VECTOR_NO_MMAP
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace NtFx {
+namespace TestVector {
+  static_assert(std::endian::native == std::endian::little,
+      "Test vectors are little endian and are read without byte swapping.");
+
+  constexpr std::string_view binaryExt = ".f64"; ///< Binary vectors.
+  constexpr std::string_view textExt   = ".txt"; ///< Text vectors.
+  constexpr uint32_t version           = 1;      ///< Current format.
+
+  /**
+   * @brief File header. Samples follow immediately, so they are 8 byte
+   * aligned in a mapped file.
+   */
+  struct Header {
+    char magic[4]      = { 'N', 'T', 'T', 'V' }; ///< Identifies the format.
+    uint32_t version   = TestVector::version;    ///< Format version.
+    uint32_t nChannels = 2;                      ///< Always stereo for now.
+    uint32_t reserved  = 0;                      ///< Written as zero.
+    uint64_t nFrames   = 0;                      ///< Number of samples pr ch.
+  };
+  static_assert(sizeof(Header) == 24, "Header must be packed.");
+
+  /**
+   * @brief Read only view of a whole file. Mapped where mmap is available,
+   * read into memory otherwise.
+   */
+  struct MappedFile {
+    const char* data = nullptr; ///< File contents.
+    size_t size      = 0;       ///< Size of file in bytes.
+
+    MappedFile(const std::string& path) {
+#ifdef NTFX_TEST_VECTOR_NO_MMAP
+      std::ifstream file(path, std::ios::binary);
+      if (!file) { return; }
+      this->buffer.assign(std::istreambuf_iterator<char>(file),
+          std::istreambuf_iterator<char>());
+      this->data = this->buffer.data();
+      this->size = this->buffer.size();
+#else
+      const int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0) { return; }
+      struct stat st;
+      if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* p = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE,
+            fd, 0);
+        if (p != MAP_FAILED) {
+          this->data = static_cast<const char*>(p);
+          this->size = size_t(st.st_size);
+        }
+      }
+      ::close(fd);
+#endif
+    }
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() {
+#ifndef NTFX_TEST_VECTOR_NO_MMAP
+      if (this->data) { ::munmap(const_cast<char*>(this->data), this->size); }
+#endif
+    }
+
+  private:
+#ifdef NTFX_TEST_VECTOR_NO_MMAP
+    std::vector<char> buffer;
+#endif
+  };
+
+  /**
+   * @brief Reads a binary vector.
+   *
+   * @param path Path of file.
+   * @param x Samples are stored here.
+   * @param error Reason for failure.
+   * @return bool True on success.
+   */
+  template <typename signal_t>
+  bool readBinary(const std::string& path,
+      std::vector<Stereo<signal_t>>& x,
+      std::string& error) {
+    MappedFile file(path);
+    if (!file.data) {
+      error = "Could not read '" + path + "'.";
+      return false;
+    }
+    const Header ref;
+    Header h;
+    if (file.size < sizeof(Header)) {
+      error = "'" + path + "' is too short for a header.";
+      return false;
+    }
+    std::memcpy(&h, file.data, sizeof(Header));
+    if (std::memcmp(h.magic, ref.magic, sizeof(ref.magic))
+        || h.version != ref.version || h.nChannels != ref.nChannels) {
+      error = "'" + path + "' is not a stereo test vector.";
+      return false;
+    }
+    if ((file.size - sizeof(Header)) / (2 * sizeof(double)) < h.nFrames) {
+      error = "'" + path + "' is truncated.";
+      return false;
+    }
+    const double* p = reinterpret_cast<const double*>(file.data + sizeof(h));
+    x.resize(h.nFrames);
+    for (size_t i = 0; i < x.size(); i++) {
+      x[i] = { signal_t(p[2 * i]), signal_t(p[2 * i + 1]) };
+    }
+    return true;
+  }
+
+  /**
+   * @brief Writes a binary vector.
+   *
+   * @param path Path of file. Overwritten if it exists.
+   * @param x Samples to write.
+   * @return bool True on success.
+   */
+  template <typename signal_t>
+  bool writeBinary(
+      const std::string& path, const std::vector<Stereo<signal_t>>& x) {
+    Header h;
+    h.nFrames = x.size();
+    std::vector<double> samples(2 * x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+      samples[2 * i]     = double(x[i].l);
+      samples[2 * i + 1] = double(x[i].r);
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    file.write(reinterpret_cast<const char*>(samples.data()),
+        std::streamsize(samples.size() * sizeof(double)));
+    return bool(file);
+  }
+
+  /**
+   * @brief Reads a vector stored as two columns of text. Lines that can not
+   * be parsed are read as zeros.
+   *
+   * @param path Path of file.
+   * @param x Samples are stored here.
+   * @return bool True if the file could be opened.
+   */
+  template <typename signal_t>
+  bool readText(const std::string& path, std::vector<Stereo<signal_t>>& x) {
+    std::ifstream file(path);
+    if (!file) { return false; }
+    x.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+      std::istringstream iss(line);
+      double l, r;
+      if (iss >> l >> r) {
+        x.push_back({ signal_t(l), signal_t(r) });
+      } else {
+        x.push_back({ 0, 0 });
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Loads a vector by path without extension. The binary file is used
+   * if it exists. Otherwise the text file is read and converted, so that it
+   * is only parsed once.
+   *
+   * @param basePath Path without extension.
+   * @param x Samples are stored here.
+   * @param error Reason for failure.
+   * @return bool True on success.
+   */
+  template <typename signal_t>
+  bool load(const std::string& basePath,
+      std::vector<Stereo<signal_t>>& x,
+      std::string& error) {
+    const auto binPath = basePath + std::string(binaryExt);
+    if (std::filesystem::exists(binPath)) {
+      return readBinary(binPath, x, error);
+    }
+    const auto txtPath = basePath + std::string(textExt);
+    if (!readText(txtPath, x)) {
+      error = "'" + binPath + "' not found.";
+      return false;
+    }
+    if (!writeBinary(binPath, x)) {
+      std::cout << "Could not convert '" << txtPath << "' to binary.\n";
+    }
+    return true;
+  }
+}
+}
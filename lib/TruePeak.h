@@ -0,0 +1,108 @@
+#pragma once
+
+/**
+ * @file TruePeak.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Inter-sample peak estimation by oversampling.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "gcem.hpp"
+#include "lib/Component.h"
+#include "lib/Stereo.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace NtFx {
+
+/**
+ * @brief Estimates the true peak, the peak of the continuous signal a DAC
+ * would reconstruct, as in ITU-R BS.1770. The input is interpolated 4x with a
+ * 48 tap polyphase FIR, a Hann windowed sinc, and the output is the largest
+ * absolute value of the sample and the three points following it.
+ *
+ * The output at sample n covers the interval from sample n - getLatency() up
+ * to the next sample. Since the first phase is the sample itself, the estimate
+ * is never below the sample peak.
+ *
+ * @tparam signal_t Audio datatype.
+ */
+template <typename signal_t>
+struct TruePeak final : public Component<Stereo<signal_t>> {
+  static constexpr size_t nPhases = 4;
+  static constexpr size_t nTaps   = 12; ///< Taps per phase.
+  std::array<std::array<signal_t, nTaps>, nPhases> h;
+  std::array<Stereo<signal_t>, nTaps * 2> dl; ///< Doubled, so reads are flat.
+  size_t idx { 0 };
+
+  TruePeak() {
+    for (size_t p = 0; p < nPhases; p++) {
+      signal_t sum = 0;
+      for (size_t j = 0; j < nTaps; j++) {
+        // Time relative to the interpolated point.
+        const double t = double(j) - double(nTaps / 2)
+            + double(p) / double(nPhases);
+        const double w = 0.5 + 0.5 * std::cos(GCEM_PI * t / (nTaps / 2 + 1));
+        this->h[p][j]  = t == 0 ? 1 : std::sin(GCEM_PI * t) / (GCEM_PI * t) * w;
+        sum += this->h[p][j];
+      }
+      for (auto& b : this->h[p]) { b /= sum; }
+    }
+    this->dl.fill(Stereo<signal_t>(0));
+  }
+
+  /**
+   * @brief Adds a sample and returns the true peak estimate.
+   *
+   * @param x Input.
+   * @return Stereo<signal_t> Absolute true peak of each channel.
+   */
+  virtual Stereo<signal_t> process(Stereo<signal_t> x) noexcept override {
+    this->dl[this->idx]         = x;
+    this->dl[this->idx + nTaps] = x;
+    // Newest sample at 'p_x[0]', oldest at 'p_x[nTaps - 1]'.
+    const auto p_x = this->dl.data() + this->idx;
+    this->idx      = this->idx == 0 ? nTaps - 1 : this->idx - 1;
+    Stereo<signal_t> y = p_x[nTaps / 2].abs();
+    for (size_t p = 1; p < nPhases; p++) {
+      Stereo<signal_t> acc = 0;
+      for (size_t j = 0; j < nTaps; j++) { acc += p_x[j] * this->h[p][j]; }
+      y = { std::max(y.l, std::abs(acc.l)), std::max(y.r, std::abs(acc.r)) };
+    }
+    return y;
+  }
+
+  virtual void processBlock(const Stereo<signal_t>* x,
+      Stereo<signal_t>* y,
+      size_t n) noexcept override {
+    for (size_t i = 0; i < n; i++) { y[i] = this->process(x[i]); }
+  }
+
+  virtual void reset(float fs) noexcept override {
+    this->fs  = fs;
+    this->idx = 0;
+    this->dl.fill(Stereo<signal_t>(0));
+  }
+
+  /**
+   * @brief Delay of the estimate in samples.
+   */
+  static constexpr size_t getLatency() noexcept { return nTaps / 2; }
+};
+}
@@ -24,11 +24,37 @@
  */
 
 #include "gcem.hpp"
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <vector>
 
 namespace NtFx {
+/**
+ * @brief A bool written by the audio thread and read by the UI thread. Copies
+ * and converts like a bool, so specs can still be built with designated
+ * initializers and plugins stay copyable.
+ */
+struct UiFlag {
+  std::atomic<bool> val;
+  UiFlag(bool val = false) noexcept : val(val) { }
+  UiFlag(const UiFlag& other) noexcept : val(bool(other)) { }
+  UiFlag& operator=(const UiFlag& other) noexcept {
+    return *this = bool(other);
+  }
+  UiFlag& operator=(bool val) noexcept {
+    this->val.store(val, std::memory_order_release);
+    return *this;
+  }
+  operator bool() const noexcept {
+    return this->val.load(std::memory_order_acquire);
+  }
+  /** Sets a new value and returns the old one. */
+  bool exchange(bool val) noexcept {
+    return this->val.exchange(val, std::memory_order_acq_rel);
+  }
+};
+
 /**
  * @brief Specification for a knob.
  *
@@ -45,8 +71,11 @@ struct KnobSpec {
   signal_t minVal { 0.0 };   ///< Starting level of knob.
   signal_t maxVal { 1.0 };   ///< End level of knob,
   bool logScale { false };   ///< Call setLogScale at construction.
-  bool isActive { true };    ///< Gray out knob and make it unresponsive.
+  UiFlag isActive { true };  ///< Gray out knob and make it unresponsive.
   signal_t midPoint { 0.0 }; ///< Sets the middel of the knob. 0 for don't care.
+  /** Jump to new values at the start of a block instead of ramping. For knobs
+   * that change the latency, like lookahead. */
+  bool stepped { false };
   signal_t _defaultVal;      ///< Default value. Set by updateDefaults().
   void setLogScale() {       ///< Sets midPoint for logarithmic scale.
     this->midPoint = gcem::sqrt(this->minVal * this->maxVal);
@@ -77,6 +106,16 @@ struct ToggleSetSpec {
 
 constexpr int nMetersMax = 8; ///< Size of meter peak level array and thus max
                               ///< number of meters available.
+
+/**
+ * @brief Signal a meter shows.
+ */
+enum struct MeterSource {
+  plugin, ///< Fed by the plugin through tap() in process().
+  input,  ///< Input of the plugin, measured by the wrapper per block.
+  output, ///< Output of the plugin, measured by the wrapper per block.
+};
+
 /**
  * @brief Specification for meters.
  *
@@ -92,6 +131,8 @@ struct MeterSpec {
   /** Adds RMS to meter. Currently works for the first two meters. RMS of input
    * will be added to meter 0 and RMS of output will be added to meter 1.*/
   bool addRms = false;
+  /** Signal shown. Input and output meters cost nothing in process(). */
+  MeterSource source { MeterSource::plugin };
 };
 
 /**
@@ -125,16 +166,19 @@ struct TitleBarSpec {
         nullptr,
         "Oversampling",
         { "disable",
-            // TODO: IIR oversampling
-            // "iir_2x",
-            // "iir_4x",
-            // "iir_8x",
             "fir_2x_lq",
             "fir_4x_lq",
             "fir_8x_lq",
             "fir_2x_hq",
             "fir_4x_hq",
-            "fir_8x_hq" },
+            "fir_8x_hq",
+            "hb_2x",
+            "hb_4x",
+            "hb_8x",
+            "hb_16x",
+            "iir_2x",
+            "iir_4x",
+            "iir_8x" },
         0,
     },
   };
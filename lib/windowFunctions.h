@@ -627,4 +627,82 @@ inline static std::vector<T> windowMethod(T fc, size_t n, T fs) {
   for (size_t i = 0; i < n; i++) { bFull[i] *= hanningWindow[i]; }
   return bFull;
 }
+
+/**
+ * @brief Designs a half-band lowpass filter with a Blackman-Harris windowed
+ * sinc. Every other tap besides the center tap is zero. The even taps are
+ * normalized to sum to 0.5, so both polyphase branches have unity gain at DC.
+ *
+ * @tparam T Datatype.
+ * @param n Length of the filter. Must be 4 * m - 1.
+ * @return std::vector<T> Filter coefficients.
+ */
+template <typename T>
+inline static std::vector<T> halfBand(size_t n) {
+  assert(n % 4 == 3);
+  auto w         = blackmanharris<T>(n, true);
+  const size_t c = (n - 1) / 2;
+  std::vector<T> b(n, 0.0);
+  T sumEven = 0;
+  for (size_t i = 0; i < n; i += 2) {
+    T t  = (T(i) - T(c)) / T(2);
+    b[i] = T(0.5) * std::sin(T(GCEM_PI) * t) / (T(GCEM_PI) * t) * w[i];
+    sumEven += b[i];
+  }
+  for (size_t i = 0; i < n; i += 2) { b[i] *= T(0.5) / sumEven; }
+  b[c] = 0.5;
+  return b;
+}
+
+/**
+ * @brief Designs the coefficients for a polyphase allpass half-band filter,
+ * which is two parallel chains of first order allpass sections in z^2. The
+ * design is elliptic, so the stopband attenuation follows from the number of
+ * coefficients and the transition band. Even coefficients belong to the
+ * first chain, odd coefficients to the second.
+ *
+ * @tparam T Datatype.
+ * @param nCoeffs Number of coefficients.
+ * @param transition Transition bandwidth relative to the sample rate of the
+ * filter. The passband ends at (0.25 - transition) * fs.
+ * @return std::vector<T> Coefficients in increasing order.
+ */
+template <typename T>
+inline static std::vector<T> allpassHalfBand(size_t nCoeffs, T transition) {
+  assert(transition > 0 && transition < 0.5);
+  double k = std::tan((1 - transition * 2) * GCEM_PI / 4);
+  k *= k;
+  const double kkSqrt = std::pow(1 - k * k, 0.25);
+  const double e      = 0.5 * (1 - kkSqrt) / (1 + kkSqrt);
+  const double e4     = e * e * e * e;
+  const double q      = e * (1 + e4 * (2 + e4 * (15 + 150 * e4)));
+  const double order  = nCoeffs * 2 + 1;
+  std::vector<T> a(nCoeffs);
+  for (size_t iCoeff = 0; iCoeff < nCoeffs; iCoeff++) {
+    const double c = iCoeff + 1;
+    double num     = 0;
+    double sign    = 1;
+    for (int i = 0;; i++) {
+      double term = std::pow(q, i * (i + 1))
+          * std::sin((i * 2 + 1) * c * GCEM_PI / order) * sign;
+      num += term;
+      sign = -sign;
+      if (std::abs(term) <= 1e-100) { break; }
+    }
+    double den = 0;
+    sign       = -1;
+    for (int i = 1;; i++) {
+      double term
+          = std::pow(q, i * i) * std::cos(i * 2 * c * GCEM_PI / order) * sign;
+      den += term;
+      sign = -sign;
+      if (std::abs(term) <= 1e-100) { break; }
+    }
+    const double ww   = num * std::pow(q, 0.25) / (den + 0.5);
+    const double wwSq = ww * ww;
+    const double x    = std::sqrt((1 - wwSq * k) * (1 - wwSq / k)) / (1 + wwSq);
+    a[iCoeff]         = T((1 - x) / (1 + x));
+  }
+  return a;
+}
 } // namespace NtFx
@@ -32,6 +32,8 @@ PLUGINS_DIR = "plugins"
 BUILD_DIR = "build"
 ARTIFACTS_DIR = "artifacts"
 JUCE_WRAPPER_DIR = "JuceWrapper"
+RENDER_WRAPPER_DIR = "renderWrapper"
+RENDER_BUILD_DIR = f"{BUILD_DIR}{os.sep}render"
 ID_FILE = f"{JUCE_WRAPPER_DIR}/pluginIds.txt"
 TEST_SCRIPT_DIR = "testWrapper"
 TEST_DIR = "test"
@@ -298,6 +300,66 @@ def process(
     return True
 
 
+def buildRenderer(plugin: str) -> str:
+    """
+    Configures and builds the headless renderer for a plugin. Each plugin gets
+    its own build dir, so switching between plugins does not rebuild.
+
+    Args:
+        plugin (str): Name of plugin to build renderer for.
+
+    Returns:
+        str: Path to the renderer executable. Empty on failure.
+    """
+    buildDir = f"{RENDER_BUILD_DIR}{os.sep}{plugin}"
+    args = [
+        "cmake",
+        "-B",
+        buildDir,
+        "-S",
+        RENDER_WRAPPER_DIR,
+        f"-DNTFX_PLUGIN={plugin}",
+        "-DCMAKE_BUILD_TYPE=Release",
+    ]
+    res = subprocess.run(args, check=False, capture_output=True)
+    if res.returncode:
+        print(f"Cmake config failed: {res.stderr.decode()}")
+        return ""
+    args = ["cmake", "--build", buildDir, "--config", "Release"]
+    res = subprocess.run(args, check=False, capture_output=True)
+    if res.returncode:
+        print(f"Build failed: {res.stdout.decode()}{res.stderr.decode()}")
+        return ""
+    exe = f"{plugin}_render{".exe" if sys.platform == "win32" else ""}"
+    for path in [
+        f"{buildDir}{os.sep}{exe}",
+        f"{buildDir}{os.sep}Release{os.sep}{exe}",
+    ]:
+        if os.path.exists(path):
+            return path
+    print(f"Renderer not found in '{buildDir}'.")
+    return ""
+
+
+def render(plugin: str, renderArgs: list[str]) -> bool:
+    """
+    Renders audio files through a plugin without a DAW.
+
+    Args:
+        plugin (str): Name of plugin to render with.
+        renderArgs (list[str]): Arguments for the renderer. Run with '-h' for
+            more.
+
+    Returns:
+        bool: True on success.
+    """
+    exe = buildRenderer(plugin)
+    if not exe:
+        return False
+    res = subprocess.run([exe] + renderArgs, check=False)
+    return not bool(res.returncode)
+
+
 def newPlugin(name: str) -> bool:
     """
     Creates a new plugin.  If Vscode is installed, opens the file.
@@ -447,6 +509,17 @@ def createParser() -> argparse.ArgumentParser:
         parents=[test.createParser()],
         add_help=False,
     )
+    renderParser = subParsers.add_parser(
+        "render",
+        help="Render audio files through a plugin without a DAW.",
+    )
+    renderParser.add_argument("plugin", help="Name of plugin.")
+    renderParser.add_argument(
+        "args",
+        nargs=argparse.REMAINDER,
+        help="Arguments for the renderer, e.g. 'in.wav out.wav -p "
+        "preset.json'. Use '-h' for more.",
+    )
     newParser = subParsers.add_parser("new", help="Create a new plugin.")
     newParser.add_argument("name", help="Name of plugin.")
     newParser.add_argument(
@@ -470,6 +543,8 @@ def main() -> bool:
         return process(args["plugins"], args["test"], args["category"])
     if args["task"] == "test":
         return test.main(args)
+    if args["task"] == "render":
+        return render(args["plugin"], args["args"])
     if args["task"] == "new":
         if "test" in args and args["test"]:
             newPluginTest(args["name"])
@@ -54,9 +54,17 @@ struct gainExample : NtFx::NtPlugin<signal_t> {
     // Let's make the meter smaller.
     this->uiSpec.meterHeight_dots = 8;
 
-    // Add two meters.
-    this->meters.push_back({ .name = "IN" });
-    this->meters.push_back({ .name = "OUT", .hasScale = true });
+    // Add two meters. The wrapper measures the input and output, so process()
+    // does not have to.
+    this->meters.push_back({
+        .name   = "IN",
+        .source = NtFx::MeterSource::input,
+    });
+    this->meters.push_back({
+        .name     = "OUT",
+        .hasScale = true,
+        .source   = NtFx::MeterSource::output,
+    });
 
     // Always remember to update defaults. This will load the member values into
     // the UI and session storage.
@@ -65,16 +73,8 @@ struct gainExample : NtFx::NtPlugin<signal_t> {
 
   // Override the process method.
   NtFx::Stereo<signal_t> process(NtFx::Stereo<signal_t> x) noexcept override {
-
-    // Update the input meter.
-    this->template updatePeakLevel<0>(x);
-
     // Calculate gain
-    NtFx::Stereo<signal_t> y = x * this->gain_lin;
-
-    // Update output meter.
-    this->template updatePeakLevel<1>(y);
-    return y;
+    return x * this->gain_lin;
   }
 
   // Override the process method.
@@ -22,20 +22,22 @@
 
 #include "lib/Biquad.h"
 #include "lib/Comp.h"
+#include "lib/DelayLine.h"
 #include "lib/Plugin.h"
 #include "lib/SoftClip.h"
 #include "lib/Stereo.h"
 #include "lib/utils.h"
 #include <algorithm>
+#include <array>
 
 enum scMode { feedForward = 0, feedback, external };
 
 template <typename signal_t>
 struct ntCompressor : public NtFx::NtPlugin<signal_t> {
   NtFx::Comp::ScSettings<signal_t> scSettings;
-  NtFx::Comp::PeakSideChainDb<signal_t> peakScDb;
+  NtFx::Comp::PeakSideChainDb<signal_t, NtFx::FastMath> peakScDb;
   NtFx::Comp::PeakSideChainLinear<signal_t> peakScLin;
-  NtFx::Comp::RmsSideChainDb<signal_t> rmsScDb;
+  NtFx::Comp::RmsSideChainDb<signal_t, NtFx::FastMath> rmsScDb;
   NtFx::Comp::RmsSideChainLinear<signal_t> rmsScLin;
 
   signal_t makeup_db   = signal_t(0.0);
@@ -54,6 +56,7 @@ struct ntCompressor : public NtFx::NtPlugin<signal_t> {
 
   NtFx::Biquad::EqBand<signal_t> hpf;
   NtFx::Biquad::EqBand<signal_t> boost;
+  NtFx::DelayLine<signal_t> lookaheadDelay;
 
   ntCompressor()
       : peakScDb(scSettings), peakScLin(scSettings), rmsScDb(scSettings),
@@ -127,6 +130,14 @@ struct ntCompressor : public NtFx::NtPlugin<signal_t> {
           .minVal = 0.0,
           .maxVal = 24.0,
       },
+      {
+          .p_val   = &this->scSettings.tLookahead_ms,
+          .name    = "Lookahead",
+          .suffix  = " ms",
+          .minVal  = 0.0,
+          .maxVal  = NtFx::Comp::maxLookahead_ms,
+          .stepped = true,
+      },
       {
           .p_val  = &this->mix_percent,
           .name   = "Mix",
@@ -160,24 +171,30 @@ struct ntCompressor : public NtFx::NtPlugin<signal_t> {
     });
 
     this->meters = {
-      { .name = "IN", .addRms = true },
-      { .name = "OUT", .hasScale = true, .addRms = true },
+      { .name = "IN", .addRms = true, .source = NtFx::MeterSource::input },
+      {
+          .name     = "OUT",
+          .hasScale = true,
+          .addRms   = true,
+          .source   = NtFx::MeterSource::output,
+      },
       { .name = "GR", .invert = true, .hasScale = true },
     };
-    this->hpf.settings.fc_hz   = 20;
-    this->boost.settings.fc_hz = 3000.0;
-    this->hpf.settings.shape   = NtFx::Biquad::Shape::hpf;
-    this->boost.settings.shape = NtFx::Biquad::Shape::bell;
+    this->hpf.settings.fc_hz           = 20;
+    this->boost.settings.fc_hz         = 3000.0;
+    this->hpf.settings.shape           = NtFx::Biquad::Shape::hpf;
+    this->boost.settings.shape         = NtFx::Biquad::Shape::bell;
+    this->lookaheadDelay.maxDelay_s    = NtFx::Comp::maxLookahead_ms / 1000;
+    this->lookaheadDelay.interpolation = NtFx::Interpolation::none;
     this->updateDefaults();
   }
 
   NtFx::Stereo<signal_t> process(NtFx::Stereo<signal_t> x) noexcept override {
-    this->template updatePeakLevel<0>(x);
-    if (this->bypassEnable) {
-      this->template updatePeakLevel<1>(x);
-      return x;
-    }
+    // The side chain sees the input early. Everything else is delayed.
+    auto xDelay = this->lookaheadDelay.process(x);
+    if (this->bypassEnable) { return xDelay; }
     NtFx::ensureFinite(x);
+    NtFx::ensureFinite(xDelay);
     NtFx::ensureFinite(this->fbState);
     NtFx::Stereo<signal_t> xHpf = x;
     if (this->scMode == scMode::feedback) {
@@ -203,19 +220,94 @@ struct ntCompressor : public NtFx::NtPlugin<signal_t> {
         gr = peakScDb.process(xSc);
       }
     }
-    this->template updatePeakLevel<2, true>(gr);
+    this->template tap<2>(gr);
     NtFx::ensureFinite(gr, signal_t(1.0));
-    NtFx::Stereo<signal_t> yComp = x * gr;
+    NtFx::Stereo<signal_t> yComp = xDelay * gr;
     this->fbState                = yComp;
     auto xClip                   = yComp * this->makeup_lin;
     auto xMix                    = xClip;
     if (this->clip) { xMix = NtFx::softClip5thStereo<signal_t>(xClip); }
-    auto y = this->mix_lin * xMix + (1 - this->mix_lin) * x;
-    this->template updatePeakLevel<1>(y);
+    auto y = this->mix_lin * xMix + (1 - this->mix_lin) * xDelay;
     if (this->scListenEnable) { return xSc; }
     return y;
   }
 
+  /**
+   * @brief Same as process() run per sample, but each component runs over a
+   * chunk of the block at a time and is timed as a stage of its own when
+   * profiling. Feedback needs the output of the previous sample, so that mode
+   * and bypass go through process().
+   */
+  void processBlock(const NtFx::Stereo<signal_t>* x,
+      NtFx::Stereo<signal_t>* y,
+      size_t n) noexcept override {
+    if (this->bypassEnable || this->scMode == scMode::feedback) {
+      NtFx::NtPlugin<signal_t>::processBlock(x, y, n);
+      return;
+    }
+    constexpr size_t chunkLen = NtFx::nMeterTapFrames;
+    std::array<NtFx::Stereo<signal_t>, chunkLen> xDelay, xSc, gr;
+    this->tapBuffered = true;
+    for (size_t i0 = 0; i0 < n; i0 += chunkLen) {
+      const size_t m = std::min(chunkLen, n - i0);
+      for (size_t i = 0; i < m; i++) {
+        xSc[i] = x[i0 + i];
+        NtFx::ensureFinite(xSc[i]);
+      }
+      if (this->scMode == scMode::external) {
+        for (size_t i = 0; i < m; i++) {
+          if (this->xScBlock) { this->xSc = this->xScBlock[i0 + i]; }
+          xSc[i] = this->xSc;
+        }
+      }
+      {
+        NTFX_PROFILE_SCOPE(this->profile, "comp.delay");
+        for (size_t i = 0; i < m; i++) {
+          xDelay[i] = this->lookaheadDelay.process(x[i0 + i]);
+          NtFx::ensureFinite(xDelay[i]);
+        }
+      }
+      {
+        NTFX_PROFILE_SCOPE(this->profile, "comp.filters");
+        this->hpf.processBlock(xSc.data(), xSc.data(), m);
+        this->boost.processBlock(xSc.data(), xSc.data(), m);
+      }
+      {
+        NTFX_PROFILE_SCOPE(this->profile, "comp.sideChain");
+        this->_sideChain().processBlock(xSc.data(), gr.data(), m);
+      }
+      {
+        NTFX_PROFILE_SCOPE(this->profile, "comp.output");
+        for (size_t i = 0; i < m; i++) {
+          this->iTapFrame = i;
+          this->template tap<2>(gr[i]);
+          NtFx::ensureFinite(gr[i], signal_t(1.0));
+          const auto yComp = xDelay[i] * gr[i];
+          this->fbState    = yComp;
+          auto xMix        = yComp * this->makeup_lin;
+          if (this->clip) { xMix = NtFx::softClip5thStereo<signal_t>(xMix); }
+          y[i0 + i] = this->scListenEnable
+              ? xSc[i]
+              : this->mix_lin * xMix + (1 - this->mix_lin) * xDelay[i];
+        }
+      }
+      this->_reduceTaps(m);
+    }
+    this->tapBuffered = false;
+  }
+
+  /**
+   * @brief The side chain selected by the domain and sensor options.
+   */
+  NtFx::Component<NtFx::Stereo<signal_t>>& _sideChain() noexcept {
+    if (this->linEnable) {
+      if (this->rmsEnable) { return this->rmsScLin; }
+      return this->peakScLin;
+    }
+    if (this->rmsEnable) { return this->rmsScDb; }
+    return this->peakScDb;
+  }
+
   void update() noexcept override {
     this->hpf.update();
     this->boost.update();
@@ -223,8 +315,13 @@ struct ntCompressor : public NtFx::NtPlugin<signal_t> {
     this->peakScLin.update();
     this->rmsScDb.update();
     this->rmsScLin.update();
-    this->makeup_lin = NtFx::invDb(this->makeup_db);
-    this->mix_lin    = this->mix_percent / 100.0;
+    this->makeup_lin           = NtFx::invDb(this->makeup_db);
+    this->mix_lin              = this->mix_percent / 100.0;
+    this->lookaheadDelay.delay = this->getLatencySamples();
+  }
+
+  float getLatencySamples() const noexcept override {
+    return float(this->peakScDb.getLatencySamples());
   }
 
   void reset(float fs) noexcept override {
@@ -236,6 +333,7 @@ struct ntCompressor : public NtFx::NtPlugin<signal_t> {
     this->rmsScLin.reset(this->fs);
     this->hpf.reset(this->fs);
     this->boost.reset(this->fs);
+    this->lookaheadDelay.reset(this->fs);
     this->update();
   }
 };
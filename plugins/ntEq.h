@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2026 Niels Thøgersen, NTlyd
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * You are free to download, build and use this code for commercial
+ * purposes. Just don't resell it or a build of it, modified or otherwise.
+ **/
+
+/**
+ * @brief An 8-band parametric EQ. All bands run in a single Biquad::Bank, so
+ * the bands are processed side by side in SIMD registers.
+ *
+ **/
+
+#pragma once
+
+#include "lib/Biquad.h"
+#include "lib/Plugin.h"
+#include "lib/Simd.h"
+#include "lib/Stereo.h"
+#include "lib/utils.h"
+#include <algorithm>
+#include <array>
+#include <string>
+
+template <typename signal_t>
+struct ntEq : public NtFx::NtPlugin<signal_t> {
+  static constexpr size_t nBands = 8;
+
+  /**
+   * @brief Shape of each option of the shape drop downs.
+   */
+  static constexpr std::array<NtFx::Biquad::Shape, 7> shapes = {
+    NtFx::Biquad::Shape::bell,
+    NtFx::Biquad::Shape::loShelf,
+    NtFx::Biquad::Shape::hiShelf,
+    NtFx::Biquad::Shape::hpf,
+    NtFx::Biquad::Shape::lpf,
+    NtFx::Biquad::Shape::notch,
+    NtFx::Biquad::Shape::none,
+  };
+
+  std::array<signal_t, nBands> fc_hz = {
+    50, 100, 250, 500, 1e3, 2.5e3, 5e3, 10e3,
+  };
+  std::array<signal_t, nBands> gain_db = { };
+  std::array<signal_t, nBands> q       = {
+    0.707, 0.707, 1, 1, 1, 1, 0.707, 0.707,
+  };
+  /** Index into 'shapes' per band. The outer bands are off by default. */
+  std::array<int, nBands> shape = { 6, 1, 0, 0, 0, 0, 2, 6 };
+  signal_t outputGain_db { 0 };
+  signal_t outputGain_lin { 1 };
+  bool bypassEnable { false };
+
+  NtFx::Biquad::Bank<signal_t, nBands> bank;
+
+  ntEq() {
+    this->uiSpec.maxColumns         = nBands;
+    this->uiSpec.maxRows            = 3;
+    this->uiSpec.defaultWindowWidth = 1400;
+    for (size_t i = 0; i < nBands; i++) {
+      this->primaryKnobs.push_back({
+          .p_val    = &this->fc_hz[i],
+          .name     = "Freq_" + std::to_string(i + 1),
+          .suffix   = " Hz",
+          .minVal   = 20,
+          .maxVal   = 20e3,
+          .logScale = true,
+      });
+    }
+    for (size_t i = 0; i < nBands; i++) {
+      this->primaryKnobs.push_back({
+          .p_val  = &this->gain_db[i],
+          .name   = "Gain_" + std::to_string(i + 1),
+          .suffix = " dB",
+          .minVal = -18,
+          .maxVal = 18,
+      });
+    }
+    for (size_t i = 0; i < nBands; i++) {
+      this->primaryKnobs.push_back({
+          .p_val    = &this->q[i],
+          .name     = "Q_" + std::to_string(i + 1),
+          .suffix   = "",
+          .minVal   = 0.1,
+          .maxVal   = 10,
+          .midPoint = 1,
+      });
+    }
+    for (size_t i = 0; i < nBands; i++) {
+      this->dropdowns.push_back({
+          .p_val   = &this->shape[i],
+          .name    = "Shape_" + std::to_string(i + 1),
+          .options = { "Bell", "Low Shelf", "High Shelf", "HPF", "LPF",
+              "Notch", "Off" },
+      });
+    }
+    this->secondaryKnobs = {
+      {
+          .p_val  = &this->outputGain_db,
+          .name   = "Out",
+          .suffix = " dB",
+          .minVal = -18,
+          .maxVal = 18,
+      },
+    };
+    this->toggles = { { &this->bypassEnable, "Bypass" } };
+    this->meters  = {
+      { .name = "IN", .addRms = true, .source = NtFx::MeterSource::input },
+      {
+          .name     = "OUT",
+          .hasScale = true,
+          .addRms   = true,
+          .source   = NtFx::MeterSource::output,
+      },
+    };
+    this->updateDefaults();
+  }
+
+  NtFx::Stereo<signal_t> process(NtFx::Stereo<signal_t> x) noexcept override {
+    if (this->bypassEnable) { return x; }
+    return this->bank.process(x) * this->outputGain_lin;
+  }
+
+  void processBlock(const NtFx::Stereo<signal_t>* x,
+      NtFx::Stereo<signal_t>* y,
+      size_t n) noexcept override {
+    if (this->bypassEnable) {
+      if (x != y) { std::copy(x, x + n, y); }
+      return;
+    }
+    this->bank.processBlock(x, y, n);
+    NtFx::Simd::applyGain(
+        y, y, n, NtFx::Stereo<signal_t>(this->outputGain_lin));
+  }
+
+  void update() noexcept override {
+    bool uiChanged = false;
+    for (size_t i = 0; i < nBands; i++) {
+      auto& s   = this->bank.settings[i];
+      s.shape   = this->shapes[size_t(this->shape[i]) % this->shapes.size()];
+      s.fc_hz   = this->fc_hz[i];
+      s.gain_db = this->gain_db[i];
+      s.q       = this->q[i];
+      const bool hasGain = s.shape == NtFx::Biquad::Shape::bell
+          || s.shape == NtFx::Biquad::Shape::loShelf
+          || s.shape == NtFx::Biquad::Shape::hiShelf;
+      auto& gainKnob = this->primaryKnobs[nBands + i];
+      if (gainKnob.isActive != hasGain) {
+        gainKnob.isActive = hasGain;
+        uiChanged         = true;
+      }
+    }
+    this->bank.update();
+    this->outputGain_lin = NtFx::invDb(this->outputGain_db);
+    // Only the gain knobs graying out needs the UI rebuilt, and update() runs
+    // every slice while knobs are ramping.
+    if (uiChanged) { this->uiNeedsUpdate = true; }
+  }
+
+  void reset(float fs) noexcept override {
+    this->fs = fs;
+    this->bank.reset(fs);
+    this->update();
+  }
+};
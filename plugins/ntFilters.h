@@ -47,10 +47,8 @@ struct ntFilters : public NtFx::NtPlugin<signal_t> {
       firstOrderHpf;
   NtFx::FirstOrder::StereoFilter<signal_t, NtFx::FirstOrder::Shape::lpfZero>
       firstOrderLpf;
-  NtFx::Biquad::EqBand<signal_t> bqLpf0;
-  NtFx::Biquad::EqBand<signal_t> bqLpf1;
-  NtFx::Biquad::EqBand<signal_t> bqHpf0;
-  NtFx::Biquad::EqBand<signal_t> bqHpf1;
+  /** The biquads of both filters, HPF in bands 0 and 1, LPF in 2 and 3. */
+  NtFx::Biquad::Bank<signal_t, 4> bank;
   ntFilters() {
     this->uiSpec.defaultWindowWidth = 800;
 
@@ -115,78 +113,89 @@ struct ntFilters : public NtFx::NtPlugin<signal_t> {
       { &this->enableLpf, "LPF_on" },
     };
     this->meters = {
-      { .name = "IN", .addRms = true },
-      { .name = "OUT", .hasScale = true, .addRms = true },
+      { .name = "IN", .addRms = true, .source = NtFx::MeterSource::input },
+      {
+          .name     = "OUT",
+          .hasScale = true,
+          .addRms   = true,
+          .source   = NtFx::MeterSource::output,
+      },
     };
     this->updateDefaults();
   }
 
   NtFx::Stereo<signal_t> process(NtFx::Stereo<signal_t> x) noexcept override {
-    auto xBqHpf0 = x;
-    if ((this->orderHpf + 1) % 2) { xBqHpf0 = this->firstOrderHpf.process(x); }
-    auto yBqHpf0 = this->bqHpf0.process(xBqHpf0);
-    auto yBqHpf1 = this->bqHpf1.process(yBqHpf0);
+    return this->bank.process(this->_processFirstOrder(x));
+  }
+
+  void processBlock(const NtFx::Stereo<signal_t>* x,
+      NtFx::Stereo<signal_t>* y,
+      size_t n) noexcept override {
+    for (size_t i = 0; i < n; i++) { y[i] = this->_processFirstOrder(x[i]); }
+    this->bank.processBlock(y, y, n);
+  }
 
-    auto xLpf = yBqHpf1;
-    if (!this->enableHpf) { xLpf = x; }
-    auto xBqLpf0 = xLpf;
+  /**
+   * @brief First order sections of odd orders. The filters commute, so both
+   * run before the biquads.
+   */
+  NtFx::Stereo<signal_t> _processFirstOrder(NtFx::Stereo<signal_t> x) noexcept {
+    auto y = x;
+    if ((this->orderHpf + 1) % 2) {
+      auto yHpf = this->firstOrderHpf.process(y);
+      if (this->enableHpf) { y = yHpf; }
+    }
     if ((this->orderLpf + 1) % 2) {
-      xBqLpf0 = this->firstOrderLpf.process(xLpf);
+      auto yLpf = this->firstOrderLpf.process(y);
+      if (this->enableLpf) { y = yLpf; }
     }
-    auto yBqLpf0 = this->bqLpf0.process(xBqLpf0);
-    auto yBqLpf1 = this->bqLpf1.process(yBqLpf0);
-
-    auto y = yBqLpf1;
-    if (!this->enableLpf) { y = xLpf; }
-    this->template updatePeakLevel<0>(x);
-    this->template updatePeakLevel<1>(y);
     return y;
   }
 
-  void update() noexcept override {
-    this->primaryKnobs[1].isActive = true;
-    this->primaryKnobs[3].isActive = true;
-    this->firstOrderHpf.setFc(fHpf);
-    this->firstOrderHpf.update();
-    if (this->orderHpf == Order::fourth) {
-      this->bqHpf0.settings.q     = gcem::sqrt(this->qHpf);
-      this->bqHpf1.settings.q     = gcem::sqrt(this->qHpf);
-      this->bqHpf0.settings.shape = NtFx::Biquad::Shape::hpf;
-      this->bqHpf1.settings.shape = NtFx::Biquad::Shape::hpf;
-    } else if (this->orderHpf == Order::first) {
-      this->bqHpf0.settings.shape    = NtFx::Biquad::Shape::none;
-      this->bqHpf1.settings.shape    = NtFx::Biquad::Shape::none;
-      this->primaryKnobs[1].isActive = false;
+  /**
+   * @brief Sets up two bands of the bank as a filter of 'order'.
+   */
+  void _updateBands(size_t i0,
+      NtFx::Biquad::Shape shape,
+      Order order,
+      bool enable,
+      signal_t fc_hz,
+      signal_t q) noexcept {
+    auto& s0 = this->bank.settings[i0];
+    auto& s1 = this->bank.settings[i0 + 1];
+    if (order == Order::fourth) {
+      s0.q     = gcem::sqrt(q);
+      s1.q     = gcem::sqrt(q);
+      s0.shape = shape;
+      s1.shape = shape;
+    } else if (order == Order::first) {
+      s0.shape = NtFx::Biquad::Shape::none;
+      s1.shape = NtFx::Biquad::Shape::none;
     } else {
-      this->bqHpf0.settings.q     = this->qHpf;
-      this->bqHpf0.settings.shape = NtFx::Biquad::Shape::hpf;
-      this->bqHpf1.settings.shape = NtFx::Biquad::Shape::none;
+      s0.q     = q;
+      s0.shape = shape;
+      s1.shape = NtFx::Biquad::Shape::none;
+    }
+    if (!enable) {
+      s0.shape = NtFx::Biquad::Shape::none;
+      s1.shape = NtFx::Biquad::Shape::none;
     }
-    this->bqHpf0.settings.fc_hz = fHpf;
-    this->bqHpf1.settings.fc_hz = fHpf;
-    this->bqHpf0.update();
-    this->bqHpf1.update();
+    s0.fc_hz = fc_hz;
+    s1.fc_hz = fc_hz;
+  }
 
+  void update() noexcept override {
+    this->primaryKnobs[1].isActive = this->orderHpf != Order::first;
+    this->primaryKnobs[3].isActive = this->orderLpf != Order::first;
+    this->firstOrderHpf.setFc(fHpf);
+    this->firstOrderHpf.update();
     this->firstOrderLpf.setFc(fLpf);
     this->firstOrderLpf.update();
-    if (this->orderLpf == Order::fourth) {
-      this->bqLpf0.settings.q     = gcem::sqrt(this->qLpf);
-      this->bqLpf1.settings.q     = gcem::sqrt(this->qLpf);
-      this->bqLpf0.settings.shape = NtFx::Biquad::Shape::lpf;
-      this->bqLpf1.settings.shape = NtFx::Biquad::Shape::lpf;
-    } else if (this->orderLpf == Order::first) {
-      this->bqLpf0.settings.shape    = NtFx::Biquad::Shape::none;
-      this->bqLpf1.settings.shape    = NtFx::Biquad::Shape::none;
-      this->primaryKnobs[3].isActive = false;
-    } else {
-      this->bqLpf0.settings.q     = this->qLpf;
-      this->bqLpf0.settings.shape = NtFx::Biquad::Shape::lpf;
-      this->bqLpf1.settings.shape = NtFx::Biquad::Shape::none;
-    }
-    this->bqLpf0.settings.fc_hz = fLpf;
-    this->bqLpf1.settings.fc_hz = fLpf;
-    this->bqLpf0.update();
-    this->bqLpf1.update();
+    this->_updateBands(0, NtFx::Biquad::Shape::hpf, this->orderHpf,
+        this->enableHpf, this->fHpf, this->qHpf);
+    this->_updateBands(2, NtFx::Biquad::Shape::lpf, this->orderLpf,
+        this->enableLpf, this->fLpf, this->qLpf);
+    this->bank.update();
     this->uiNeedsUpdate = true;
   }
 
@@ -194,10 +203,7 @@ struct ntFilters : public NtFx::NtPlugin<signal_t> {
     this->fs = fs;
     this->firstOrderHpf.reset(fs);
     this->firstOrderLpf.reset(fs);
-    this->bqHpf0.reset(fs);
-    this->bqHpf1.reset(fs);
-    this->bqLpf0.reset(fs);
-    this->bqLpf1.reset(fs);
+    this->bank.reset(fs);
     this->update();
   }
 };
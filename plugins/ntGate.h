@@ -34,9 +34,9 @@ enum ScMode { internal, external, ignore };
 template <typename signal_t>
 struct ntGate : NtFx::NtPlugin<signal_t> {
   NtFx::Gate::ScSettings<signal_t> scSettings;
-  NtFx::Gate::Sc<signal_t> sc;
+  NtFx::Gate::Sc<signal_t, NtFx::FastMath> sc;
   NtFx::Gate::ScSettings<signal_t> scHfSettings;
-  NtFx::Gate::Sc<signal_t> scHf;
+  NtFx::Gate::Sc<signal_t, NtFx::FastMath> scHf;
   NtFx::DynamicFilter::Shelf<signal_t> flt;
   NtFx::Biquad::EqBand<signal_t> hpf;
   NtFx::Biquad::EqBand<signal_t> lpf;
@@ -50,6 +50,10 @@ struct ntGate : NtFx::NtPlugin<signal_t> {
   bool bypassEnable { false };
   bool scListenEnable { false };
   bool hfAccelEnable { false };
+  int xoverId { NtFx::noParamId };
+  int hfHoldId { NtFx::noParamId };
+  int hfReleaseId { NtFx::noParamId };
+  int ignoreSensId { NtFx::noParamId };
 
   ntGate() : sc(scSettings), scHf(scHfSettings) {
     this->primaryKnobs = {
@@ -155,19 +159,26 @@ struct ntGate : NtFx::NtPlugin<signal_t> {
       },
     };
     this->meters = {
-      { .name = "IN", .addRms = true },
-      { .name = "OUT", .hasScale = true, .addRms = true },
+      { .name = "IN", .addRms = true, .source = NtFx::MeterSource::input },
+      {
+          .name     = "OUT",
+          .hasScale = true,
+          .addRms   = true,
+          .source   = NtFx::MeterSource::output,
+      },
       { .name = "GR", .invert = _DO_INVERT },
       { .name = "HF_GR", .invert = _DO_INVERT, .hasScale = true },
     };
     this->updateDefaults();
+    this->xoverId      = this->getParamId("Xover");
+    this->hfHoldId     = this->getParamId("HF_Hold");
+    this->hfReleaseId  = this->getParamId("HF_Release");
+    this->ignoreSensId = this->getParamId("Ignore_Sens");
   }
 
   NtFx::Stereo<signal_t> process(NtFx::Stereo<signal_t> x) noexcept override {
-    this->template updatePeakLevel<0>(x);
     if (this->bypassEnable) {
-      this->template updatePeakLevel<1>(x);
-      this->template updatePeakLevel<2>(1);
+      this->template tap<2>(1);
       return x;
     }
     auto xSc = x;
@@ -188,10 +199,7 @@ struct ntGate : NtFx::NtPlugin<signal_t> {
     NtFx::ensureFinite(xSc);
     auto yHpf = this->hpf.process(xSc);
     auto yLpf = this->lpf.process(yHpf);
-    if (this->scListenEnable) {
-      this->template updatePeakLevel<1>(yLpf);
-      return yLpf;
-    }
+    if (this->scListenEnable) { return yLpf; }
     auto gr   = this->sc.process(yLpf);
     auto grHf = gr;
     auto y    = x * gr;
@@ -201,27 +209,17 @@ struct ntGate : NtFx::NtPlugin<signal_t> {
       flt.gain_lin = A.absMax();
       y            = this->flt.process(x) * gr;
     }
-    this->template updatePeakLevel<1>(y);
-    this->template updatePeakLevel<2, _DO_INVERT>(gr);
-    this->template updatePeakLevel<3, _DO_INVERT>(grHf);
+    this->template tap<2>(gr);
+    this->template tap<3>(grHf);
     return y;
   }
 
   void update() noexcept override {
-    if (this->hfAccelEnable) {
-      this->activateParameter("Xover");
-      this->activateParameter("HF_Hold");
-      this->activateParameter("HF_Release");
-    } else {
-      this->deactivateParameter("Xover");
-      this->deactivateParameter("HF_Hold");
-      this->deactivateParameter("HF_Release");
-    }
-    if (this->scMode == ScMode::ignore) {
-      this->activateParameter("Ignore_Sens");
-    } else {
-      this->deactivateParameter("Ignore_Sens");
-    }
+    this->setParameterActive(this->xoverId, this->hfAccelEnable);
+    this->setParameterActive(this->hfHoldId, this->hfAccelEnable);
+    this->setParameterActive(this->hfReleaseId, this->hfAccelEnable);
+    this->setParameterActive(
+        this->ignoreSensId, this->scMode == ScMode::ignore);
     this->nIgnore          = gcem::round(this->tIgnore_ms * 0.001 * this->fs);
     this->ignoreThresh_lin = NtFx::invDb(this->ignoreThresh_db);
     this->flt.q1           = 0.6;
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2026 Niels Thøgersen, NTlyd
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * You are free to download, build and use this code for commercial
+ * purposes. Just don't resell it or a build of it, modified or otherwise.
+ **/
+
+#pragma once
+
+#include "lib/Comp.h"
+#include "lib/DelayLine.h"
+#include "lib/Plugin.h"
+#include "lib/Stereo.h"
+#include "lib/TruePeak.h"
+#include "lib/utils.h"
+
+template <typename signal_t>
+struct ntLimiter : public NtFx::NtPlugin<signal_t> {
+  NtFx::Comp::ScSettings<signal_t> scSettings;
+  NtFx::Comp::LimiterSideChain<signal_t, NtFx::FastMath> sc;
+  NtFx::DelayLine<signal_t> lookaheadDelay;
+
+  signal_t input_db = signal_t(0.0);
+
+  bool bypassEnable = false;
+
+  signal_t input_lin = signal_t(1.0);
+
+  ntLimiter() : sc(scSettings) {
+    this->scSettings.thresh_db     = -1;
+    this->scSettings.tRel_ms       = 50;
+    this->scSettings.tLookahead_ms = 2;
+    this->scSettings.linkEnable    = true;
+
+    this->primaryKnobs = {
+      {
+          .p_val  = &this->input_db,
+          .name   = "Input",
+          .suffix = " dB",
+          .minVal = 0.0,
+          .maxVal = 24.0,
+      },
+      {
+          .p_val  = &this->scSettings.thresh_db,
+          .name   = "Ceiling",
+          .suffix = " dB",
+          .minVal = -24.0,
+          .maxVal = 0.0,
+      },
+      {
+          .p_val    = &this->scSettings.tRel_ms,
+          .name     = "Release",
+          .suffix   = " ms",
+          .minVal   = 1.0,
+          .maxVal   = 1000.0,
+          .midPoint = 50.0,
+      },
+      {
+          .p_val   = &this->scSettings.tLookahead_ms,
+          .name    = "Lookahead",
+          .suffix  = " ms",
+          .minVal  = 0.0,
+          .maxVal  = NtFx::Comp::maxLookahead_ms,
+          .stepped = true,
+      },
+    };
+
+    this->toggles = {
+      { .p_val = &this->sc.truePeakEnable, .name = "True_Peak" },
+      { .p_val = &this->scSettings.linkEnable, .name = "Link" },
+      { .p_val = &this->bypassEnable, .name = "Bypass" },
+    };
+
+    this->meters = {
+      { .name = "IN", .addRms = true, .source = NtFx::MeterSource::input },
+      {
+          .name     = "OUT",
+          .hasScale = true,
+          .addRms   = true,
+          .source   = NtFx::MeterSource::output,
+      },
+      { .name = "GR", .invert = true, .hasScale = true },
+    };
+    this->lookaheadDelay.interpolation = NtFx::Interpolation::none;
+    this->updateDefaults();
+  }
+
+  NtFx::Stereo<signal_t> process(NtFx::Stereo<signal_t> x) noexcept override {
+    NtFx::ensureFinite(x);
+    auto xIn    = x * this->input_lin;
+    auto gr     = this->sc.process(xIn);
+    auto xDelay = this->lookaheadDelay.process(xIn);
+    if (this->bypassEnable) {
+      return xDelay / this->input_lin;
+    }
+    this->template tap<2>(gr);
+    return xDelay * gr;
+  }
+
+  void update() noexcept override {
+    this->sc.update();
+    this->input_lin            = NtFx::invDb(this->input_db);
+    this->lookaheadDelay.delay = this->getLatencySamples();
+  }
+
+  float getLatencySamples() const noexcept override {
+    return float(this->sc.getLatencySamples());
+  }
+
+  void reset(float fs) noexcept override {
+    this->fs                        = fs;
+    this->lookaheadDelay.maxDelay_s = NtFx::Comp::maxLookahead_ms / 1000
+        + signal_t(NtFx::TruePeak<signal_t>::getLatency() + 1) / fs;
+    this->sc.reset(this->fs);
+    this->lookaheadDelay.reset(this->fs);
+    this->update();
+  }
+};
@@ -156,8 +156,19 @@ struct ntMultiband3 : public NtFx::NtPlugin<signal_t> {
       });
     }
     this->meters = {
-      { .name = "IN", .decay_s = 0.75, .addRms = true },
-      { .name = "OUT", .hasScale = true, .decay_s = 0.75, .addRms = true },
+      {
+          .name    = "IN",
+          .decay_s = 0.75,
+          .addRms  = true,
+          .source  = NtFx::MeterSource::input,
+      },
+      {
+          .name     = "OUT",
+          .hasScale = true,
+          .decay_s  = 0.75,
+          .addRms   = true,
+          .source   = NtFx::MeterSource::output,
+      },
     };
     for (int i = Bands::n - 1; i >= 0; i--) {
       this->meters.push_back({ .name = this->BandNames[i], .invert = true });
@@ -193,11 +204,9 @@ struct ntMultiband3 : public NtFx::NtPlugin<signal_t> {
       if (!this->mutes[i]) { yComp += tmp * this->makeup_lin[i]; }
     }
     auto y = yComp * this->ouputGain_lin;
-    this->template updatePeakLevel<0>(x);
-    this->template updatePeakLevel<1>(y);
-    this->template updatePeakLevel<2, true>(gr[Bands::lo]);
-    this->template updatePeakLevel<3, true>(gr[Bands::mid]);
-    this->template updatePeakLevel<4, true>(gr[Bands::hi]);
+    this->template tap<2>(gr[Bands::lo]);
+    this->template tap<3>(gr[Bands::mid]);
+    this->template tap<4>(gr[Bands::hi]);
     // if (this->noise) { return NtFx::rand<signal_t>(); }s
     return y;
   }
@@ -225,7 +234,10 @@ struct ntMultiband3 : public NtFx::NtPlugin<signal_t> {
     this->hiMidFlt.reset(this->fs);
     this->loMidFlt.reset(this->fs);
     this->loFlt.reset(this->fs);
-    for (size_t i = 0; i < Bands::n; i++) { this->sc[i].reset(this->fs); }
+    for (size_t i = 0; i < Bands::n; i++) {
+      this->sc[i].reset(this->fs);
+      this->fbState[i] = signal_t(0);
+    }
     this->update();
   }
 
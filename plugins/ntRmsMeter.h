@@ -35,7 +35,12 @@ struct ntRmsMeter : NtFx::NtPlugin<signal_t> {
 
   ntRmsMeter() {
     this->meters = {
-      { .name = "Peak", .minVal_db = -50, .addRms = true },
+      {
+          .name      = "Peak",
+          .minVal_db = -50,
+          .addRms    = true,
+          .source    = NtFx::MeterSource::input,
+      },
       { .name = "RMS", .minVal_db = -50, .hasScale = true },
     };
     this->primaryKnobs = {
@@ -51,8 +56,7 @@ struct ntRmsMeter : NtFx::NtPlugin<signal_t> {
 
   virtual NtFx::Stereo<signal_t> process(
       NtFx::Stereo<signal_t> x) noexcept override {
-    this->template updatePeakLevel<Peak>(x);
-    this->template updatePeakLevel<RMS>(msSensor.process(x));
+    this->template tap<RMS>(msSensor.process(x));
     return x;
   }
 
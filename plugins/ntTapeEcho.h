@@ -22,14 +22,15 @@
 
 #include "gcem.hpp"
 #include "lib/Biquad.h"
+#include "lib/DelayLine.h"
 #include "lib/Glider.h"
 #include "lib/Plugin.h"
 #include "lib/SoftClip.h"
 #include "lib/Stereo.h"
 #include "lib/utils.h"
-#include <algorithm>
-#include <array>
+#include <cmath>
 #include <cstddef>
+#include <limits>
 
 enum SubDev : int {
   half,
@@ -39,11 +40,10 @@ enum SubDev : int {
   sixteenth_dot,
   sixteenth,
 };
-// 192 kHz * 2 seconds * 8 x oversampling * 2 stores pr sample * 2 for mod (the
-// last doesn't need to be that big).
-// TODO: Calculate space for mod.
-// TODO: Dynamic alocation of delayline.
-constexpr int delayLineLength = 192e3 * 2 * 8 * 2 * 2;
+// Longest time of the time knob, also when synced to the tempo.
+constexpr double tTimeMax_s = 2;
+// The time knob, 1 % modulation depth and 50 ms offset.
+constexpr double tDelayMax_s = tTimeMax_s * 1.01 + 0.05;
 
 template <typename signal_t>
 struct ntTapeEcho : public NtFx::NtPlugin<signal_t> {
@@ -66,13 +66,12 @@ struct ntTapeEcho : public NtFx::NtPlugin<signal_t> {
   NtFx::Biquad::EqBand<signal_t> hpf;
   NtFx::Biquad::EqBand<signal_t> lpf;
   NtFx::Stereo<signal_t> fbState;
-  std::array<NtFx::Stereo<signal_t>, delayLineLength> delayLine;
+  NtFx::DelayLine<signal_t> delayLine;
   signal_t fb_lin    = 0.2;
   signal_t noise_lin = 0;
   signal_t tGlide    = 0.36;
   // NtFx::LinGlider<signal_t> nDelay;
   NtFx::ExpGlider<signal_t> nDelay;
-  size_t iStore      = 0;
   signal_t aClip_lin = 1;
   size_t timeCounter = 0;
   NtFx::ExpGlider<signal_t> nOffset;
@@ -85,7 +84,7 @@ struct ntTapeEcho : public NtFx::NtPlugin<signal_t> {
 
   ntTapeEcho() : modDepth(0.1) {
     this->primaryKnobs = {
-      { &this->tGui, "Time", " s", 0.02, 2 },
+      { &this->tGui, "Time", " s", 0.02, tTimeMax_s },
       { &this->fb_percent, "Feedback", " %", 0, 200 },
       { &this->clipG_db, "Drive", " dB", -20, 20 },
       { &this->hpf.settings.fc_hz, "HPF", " Hz", 20, 2000, true },
@@ -125,11 +124,20 @@ struct ntTapeEcho : public NtFx::NtPlugin<signal_t> {
       { &this->doGlide, "Glide" },
       { &this->bypass, "Bypass" },
     };
-    this->meters = { { "IN" }, { .name = "OUT", .hasScale = true } };
+    this->meters = {
+      { .name = "IN", .source = NtFx::MeterSource::input },
+      {
+          .name     = "OUT",
+          .hasScale = true,
+          .source   = NtFx::MeterSource::output,
+      },
+    };
     this->lpf.settings.shape = NtFx::Biquad::Shape::lpf;
     this->hpf.settings.shape = NtFx::Biquad::Shape::hpf;
     this->lpf.settings.fc_hz = 20e3;
     this->hpf.settings.fc_hz = 20;
+
+    this->delayLine.maxDelay_s = tDelayMax_s;
     this->updateDefaults();
   }
 
@@ -143,32 +151,21 @@ struct ntTapeEcho : public NtFx::NtPlugin<signal_t> {
     auto xNoisy = x + NtFx::rand<signal_t>() * this->noise_lin;
     NtFx::ensureFinite<NtFx::Stereo<signal_t>>(xNoisy);
     NtFx::ensureFinite<NtFx::Stereo<signal_t>>(this->fbState);
-    this->iStore++;
-    if (this->iStore >= delayLineLength) { this->iStore = 0; }
-    this->delayLine[this->iStore] = xNoisy + this->fb_lin * this->fbState;
+    this->delayLine.push(xNoisy + this->fb_lin * this->fbState);
 
-    int nModL = this->nDelay.pr;
-    int nModR = this->nDelay.pr + this->nOffset.pr;
+    NtFx::Stereo<signal_t> nMod = {
+      this->nDelay.pr,
+      this->nDelay.pr + this->nOffset.pr,
+    };
     if (this->mod) {
       auto modSawL = NtFx::saw(this->thetaMod.pr * this->timeCounter);
       auto modSawR = NtFx::saw(
           this->thetaMod.pr * this->timeCounter + this->thetaModPhase.pr);
-      nModL = gcem::round(modSawL * this->nDelay.pr * this->modDepth.pr)
-          + this->nDelay.pr;
-      nModR = gcem::round(modSawR * this->nDelay.pr * this->modDepth.pr)
-          + this->nDelay.pr + this->nOffset.pr;
+      nMod.l += modSawL * this->nDelay.pr * this->modDepth.pr;
+      nMod.r += modSawR * this->nDelay.pr * this->modDepth.pr;
       this->timeCounter++;
     }
-
-    // TODO: DelayLine class.
-    int iLoadL = this->iStore - gcem::round(nModL);
-    if (iLoadL < 0) { iLoadL += delayLineLength; }
-    int iLoadR = this->iStore - gcem::round(nModR);
-    if (iLoadR < 0) { iLoadR += delayLineLength; }
-    NtFx::Stereo<signal_t> yDelay = {
-      this->delayLine[iLoadL].l,
-      this->delayLine[iLoadR].r,
-    };
+    auto yDelay = this->delayLine.readLinear(nMod);
     auto yFbClip =
         NtFx::softClip3rdStereo(yDelay * this->aClip_lin) / aClip_lin;
     NtFx::ensureFinite<NtFx::Stereo<signal_t>>(yFbClip);
@@ -180,12 +177,7 @@ struct ntTapeEcho : public NtFx::NtPlugin<signal_t> {
     auto y = (signal_t(1.0) - this->mix_lin) * x + this->mix_lin * yOutClip;
     // TODO: Make this a member.
     y *= (2 - gcem::abs(this->mix_lin * 2 - 1));
-    this->template updatePeakLevel<0>(x);
-    if (this->bypass) {
-      this->template updatePeakLevel<1>(x);
-      return x;
-    }
-    this->template updatePeakLevel<1>(y);
+    if (this->bypass) { return x; }
     return y;
   }
 
@@ -232,17 +224,38 @@ struct ntTapeEcho : public NtFx::NtPlugin<signal_t> {
     this->nDelay.update(this->fs, tGlide);
   }
 
+  virtual float getTailSeconds() const noexcept override {
+    if (this->fs <= 0) { return 0; }
+    signal_t tDelay_s = (this->nDelay.ui + this->nOffset.ui) / this->fs;
+    if (this->fb_lin <= 0) { return tDelay_s; }
+    if (this->fb_lin >= 1) { return std::numeric_limits<float>::infinity(); }
+    // Time for the repeats to decay by 60 dB.
+    signal_t nRepeats = std::log(signal_t(1e-3)) / std::log(this->fb_lin);
+    return (nRepeats + 1) * tDelay_s;
+  }
+
   virtual void reset(float fs) noexcept override {
-    this->fs = fs;
-    std::fill(this->delayLine.begin(), this->delayLine.end(), 0);
+    this->fs          = fs;
+    this->fbState     = signal_t(0);
+    this->timeCounter = 0;
+    this->delayLine.reset(this->fs);
     this->hpf.reset(this->fs);
     this->lpf.reset(this->fs);
     this->update();
+    // Start at the settings instead of gliding from where the last run ended.
+    this->nDelay.pr        = this->nDelay.ui;
+    this->nOffset.pr       = this->nOffset.ui;
+    this->modDepth.pr      = this->modDepth.ui;
+    this->thetaMod.pr      = this->thetaMod.ui;
+    this->thetaModPhase.pr = this->thetaModPhase.ui;
   }
 
   virtual void onTempoChanged() noexcept override {
     if (this->sync && this->tempo) {
-      this->tGui                     = 60 / this->tempo * this->tempoScale;
+      // Halved until it fits the delay line, so slow tempos stay on the beat.
+      signal_t t = 60 / this->tempo * this->tempoScale;
+      while (t > tTimeMax_s) { t /= 2; }
+      this->tGui                     = t;
       this->primaryKnobs[0].isActive = false;
     } else {
       this->primaryKnobs[0].isActive = true;
@@ -43,15 +43,10 @@ struct ntTransformer : public NtFx::NtPlugin<signal_t> {
   }
   virtual NtFx::Stereo<signal_t> process(
       NtFx::Stereo<signal_t> x) noexcept override {
-    this->template updatePeakLevel<0>(x);
-    if (this->bypass) {
-      this->template updatePeakLevel<1>(x);
-      return x;
-    }
+    if (this->bypass) { return x; }
     auto xTrans = this->bqHpf0.process(x);
     auto y =
         this->transformer.process(xTrans * this->drive_lin) / this->drive_lin;
-    this->template updatePeakLevel<1>(y);
     return y;
   }
   virtual void update() noexcept override {
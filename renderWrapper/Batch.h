@@ -0,0 +1,99 @@
+#pragma once
+
+/**
+ * @file Batch.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Work stealing thread pool for batch rendering.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NtFx {
+namespace Batch {
+  /**
+   * @brief Jobs of one worker. The owner takes from the front, thieves from
+   * the back.
+   */
+  struct Queue {
+    std::mutex mutex;
+    std::deque<size_t> jobs;
+  };
+
+  /**
+   * @brief Takes the next job for a worker: its own first, then one stolen
+   * from the other workers in turn.
+   *
+   * @return bool False when all queues are empty.
+   */
+  inline bool _take(std::vector<Queue>& queues, size_t iWorker, size_t& iJob) {
+    {
+      auto& own = queues[iWorker];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.jobs.empty()) {
+        iJob = own.jobs.front();
+        own.jobs.pop_front();
+        return true;
+      }
+    }
+    for (size_t k = 1; k < queues.size(); k++) {
+      auto& other = queues[(iWorker + k) % queues.size()];
+      std::lock_guard<std::mutex> lock(other.mutex);
+      if (!other.jobs.empty()) {
+        iJob = other.jobs.back();
+        other.jobs.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Runs jobs 0 to nJobs - 1 on 'nWorkers' threads. The jobs are dealt
+   * round robin to a queue per worker, so give the longest first. A worker
+   * whose queue runs dry steals from the back of the others', which holds
+   * their shortest jobs. No jobs are added while running, so a worker is done
+   * once all queues are empty. Each job runs once, on one worker, and the
+   * worker index lets the caller keep state per worker, such as a plugin.
+   *
+   * @param nJobs Number of jobs.
+   * @param nWorkers Number of threads. The calling thread is worker 0.
+   * @param work Called as work(iWorker, iJob).
+   */
+  template <typename work_t>
+  void run(size_t nJobs, size_t nWorkers, work_t&& work) {
+    nWorkers = std::clamp(nWorkers, size_t(1), std::max(nJobs, size_t(1)));
+    std::vector<Queue> queues(nWorkers);
+    for (size_t i = 0; i < nJobs; i++) {
+      queues[i % nWorkers].jobs.push_back(i);
+    }
+    auto worker = [&](size_t iWorker) {
+      size_t iJob;
+      while (_take(queues, iWorker, iJob)) { work(iWorker, iJob); }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < nWorkers; i++) { threads.emplace_back(worker, i); }
+    worker(0);
+    for (auto& t : threads) { t.join(); }
+  }
+}
+}
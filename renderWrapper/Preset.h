@@ -0,0 +1,358 @@
+#pragma once
+
+/**
+ * @file Preset.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Parameter values for the renderer from JSON, plugin state XML or the
+ * command line.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lib/Plugin.h"
+#include "lib/UiSpec.h"
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace NtFx {
+namespace Preset {
+  /**
+   * @brief Parameter values by name, in the order they were given. Values are
+   * kept as text and interpreted by apply() from the type of the parameter.
+   */
+  using Values = std::vector<std::pair<std::string, std::string>>;
+
+  /**
+   * @brief Name of the oversampling parameter, which belongs to the wrapper
+   * rather than the plugin.
+   */
+  constexpr std::string_view oversamplingName = "Oversampling";
+
+  /**
+   * @brief Prefix of the toggles JUCE stores radio button options as.
+   */
+  constexpr std::string_view radioButtonPrefix = "radioButton:";
+
+  inline bool _fail(std::string& error, std::string msg) {
+    error = std::move(msg);
+    return false;
+  }
+
+  inline bool _parseNumber(std::string_view s, double& val) {
+    std::string str(s);
+    char* p_end;
+    val = std::strtod(str.c_str(), &p_end);
+    return !str.empty() && p_end == str.c_str() + str.size();
+  }
+
+  /**
+   * @brief Finds an option by name or by index.
+   *
+   * @return int Index of the option, or -1 if not found.
+   */
+  inline int _findOption(
+      const std::vector<std::string>& options, std::string_view value) {
+    for (size_t i = 0; i < options.size(); i++) {
+      if (options[i] == value) { return int(i); }
+    }
+    double idx;
+    if (_parseNumber(value, idx) && idx >= 0 && idx < double(options.size())
+        && idx == double(int(idx))) {
+      return int(idx);
+    }
+    return -1;
+  }
+
+  /**
+   * @brief Parses a flat JSON object, such as
+   * { "Threshold": -20, "Bypass": false, "Mode": "Peak" }. Nested objects and
+   * arrays are not supported.
+   *
+   * @param text JSON text.
+   * @param values Parsed values are appended here.
+   * @param error Reason for failure.
+   * @return bool True on success.
+   */
+  inline bool parseJson(
+      std::string_view text, Values& values, std::string& error) {
+    size_t i  = 0;
+    auto skip = [&]() {
+      while (i < text.size() && std::isspace((unsigned char)text[i])) { i++; }
+    };
+    auto readString = [&](std::string& s) {
+      if (i >= text.size() || text[i] != '"') { return false; }
+      i++;
+      s.clear();
+      while (i < text.size() && text[i] != '"') {
+        char c = text[i++];
+        if (c == '\\' && i < text.size()) {
+          c = text[i++];
+          switch (c) {
+          case 'n':
+            c = '\n';
+            break;
+          case 't':
+            c = '\t';
+            break;
+          case 'u':
+            // Parameter names are ASCII. Anything else is kept as '?'.
+            i += 4;
+            c = '?';
+            break;
+          }
+        }
+        s += c;
+      }
+      if (i >= text.size()) { return false; }
+      i++;
+      return true;
+    };
+    skip();
+    if (i >= text.size() || text[i] != '{') {
+      return _fail(error, "Expected a JSON object.");
+    }
+    i++;
+    skip();
+    if (i < text.size() && text[i] == '}') { return true; }
+    while (true) {
+      std::string key, val;
+      skip();
+      if (!readString(key)) { return _fail(error, "Expected a name."); }
+      skip();
+      if (i >= text.size() || text[i] != ':') {
+        return _fail(error, "Expected ':' after '" + key + "'.");
+      }
+      i++;
+      skip();
+      if (i < text.size() && text[i] == '"') {
+        if (!readString(val)) { return _fail(error, "Unterminated string."); }
+      } else if (i < text.size() && (text[i] == '{' || text[i] == '[')) {
+        return _fail(error, "Nested values are not supported: '" + key + "'.");
+      } else {
+        const size_t i0 = i;
+        while (i < text.size() && text[i] != ',' && text[i] != '}'
+            && !std::isspace((unsigned char)text[i])) {
+          i++;
+        }
+        val = std::string(text.substr(i0, i - i0));
+        if (val.empty()) { return _fail(error, "No value for '" + key + "'."); }
+      }
+      values.emplace_back(std::move(key), std::move(val));
+      skip();
+      if (i < text.size() && text[i] == ',') {
+        i++;
+        continue;
+      }
+      if (i < text.size() && text[i] == '}') { return true; }
+      return _fail(error, "Expected ',' or '}'.");
+    }
+  }
+
+  /**
+   * @brief Reads the parameters of a plugin state saved by the JUCE wrapper,
+   * that is all <PARAM id="..." value="..."/> elements.
+   *
+   * @param text XML text.
+   * @param values Parsed values are appended here.
+   * @param error Reason for failure.
+   * @return bool True on success.
+   */
+  inline bool parseXml(
+      std::string_view text, Values& values, std::string& error) {
+    auto attribute = [](std::string_view elem, std::string_view name) {
+      const std::string key = " " + std::string(name) + "=\"";
+      const size_t i0       = elem.find(key);
+      if (i0 == std::string_view::npos) { return std::string(); }
+      const size_t i1 = elem.find('"', i0 + key.size());
+      return std::string(elem.substr(i0 + key.size(), i1 - i0 - key.size()));
+    };
+    size_t n = 0;
+    for (size_t i = text.find("<PARAM "); i != std::string_view::npos;
+        i     = text.find("<PARAM ", i + 1)) {
+      const auto elem = text.substr(i, text.find('>', i) - i);
+      auto id         = attribute(elem, "id");
+      auto val        = attribute(elem, "value");
+      if (id.empty() || val.empty()) { continue; }
+      values.emplace_back(std::move(id), std::move(val));
+      n++;
+    }
+    if (!n) { return _fail(error, "No PARAM elements found."); }
+    return true;
+  }
+
+  /**
+   * @brief Reads a preset file. Files ending in '.xml' are read with
+   * parseXml(), all others with parseJson().
+   *
+   * @param path Path to the preset.
+   * @param values Parsed values are appended here.
+   * @param error Reason for failure.
+   * @return bool True on success.
+   */
+  inline bool read(
+      const std::string& path, Values& values, std::string& error) {
+    std::ifstream file(path);
+    if (!file) { return _fail(error, "Could not open '" + path + "'."); }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    const std::string text = ss.str();
+    const bool isXml       = path.size() >= 4
+        && path.compare(path.size() - 4, 4, ".xml") == 0;
+    bool ok = isXml ? parseXml(text, values, error)
+                    : parseJson(text, values, error);
+    if (!ok) { error = path + ": " + error; }
+    return ok;
+  }
+
+  /**
+   * @brief Parses 'name=value' as given on the command line.
+   *
+   * @param arg Argument to parse.
+   * @param values The value is appended here.
+   * @param error Reason for failure.
+   * @return bool True on success.
+   */
+  inline bool parseAssignment(
+      std::string_view arg, Values& values, std::string& error) {
+    const size_t i = arg.find('=');
+    if (i == std::string_view::npos || i == 0) {
+      return _fail(error, "Expected 'name=value', got '" + std::string(arg)
+              + "'.");
+    }
+    values.emplace_back(std::string(arg.substr(0, i)),
+        std::string(arg.substr(i + 1)));
+    return true;
+  }
+
+  /**
+   * @brief Looks up an oversampling mode by name or by index in the
+   * oversampling drop down of the title bar.
+   *
+   * @param value Name, e.g. "hb_4x", or index, 0 being "disable".
+   * @param mode Mode as used by Src::SampleRateConverter.
+   * @param error Reason for failure.
+   * @return bool True on success.
+   */
+  inline bool parseOversampling(
+      std::string_view value, int& mode, std::string& error) {
+    const TitleBarSpec titleBar;
+    for (const auto& d : titleBar.dropdowns) {
+      if (d.name != oversamplingName) { continue; }
+      const int idx = _findOption(d.options, value);
+      if (idx < 0) {
+        return _fail(error, "Unknown oversampling mode '" + std::string(value)
+                + "'.");
+      }
+      // Drop down IDs start at 1, which is also the first mode.
+      mode = idx + 1;
+      return true;
+    }
+    return _fail(error, "No oversampling drop down.");
+  }
+
+  /**
+   * @brief Sets a parameter of a plugin. Knobs take a number and are limited
+   * to the range of the knob. Toggles take true, false, on, off or a number.
+   * Drop downs and radio buttons take the name or the index of an option.
+   * Radio button options stored as toggles by the JUCE wrapper are accepted
+   * too. Call update() on the plugin when all values are set.
+   *
+   * @param plug Plugin to set the parameter on.
+   * @param name Name of the parameter.
+   * @param value Value as text.
+   * @param error Reason for failure.
+   * @return bool True on success.
+   */
+  template <typename signal_t>
+  bool apply(NtPlugin<signal_t>& plug,
+      std::string_view name,
+      std::string_view value,
+      std::string& error) {
+    const std::string quoted = "'" + std::string(name) + "'";
+    if (name.starts_with(radioButtonPrefix)) {
+      // "radioButton:[set]:[option]" with 1 for the selected option.
+      auto rest       = name.substr(radioButtonPrefix.size());
+      const size_t i  = rest.find(':');
+      const int id    = plug.getParamId(rest.substr(0, i));
+      int* p_val      = plug.getOptionValuePtr(id);
+      double selected = 0;
+      if (i == std::string_view::npos || !p_val
+          || !_parseNumber(value, selected)) {
+        return _fail(error, "Unknown parameter " + quoted + ".");
+      }
+      const auto& ref = plug.paramRegistry.refs[id];
+      const int idx
+          = _findOption(plug.radioButtons[ref.idx].options, rest.substr(i + 1));
+      if (idx < 0) { return _fail(error, "Unknown option in " + quoted + "."); }
+      if (selected != 0) { *p_val = idx; }
+      return true;
+    }
+    const int id = plug.getParamId(name);
+    if (id == noParamId) {
+      return _fail(error, "Unknown parameter " + quoted + ".");
+    }
+    const auto& ref = plug.paramRegistry.refs[id];
+    double num;
+    switch (ref.type) {
+    case ParamType::knob: {
+      if (!_parseNumber(value, num)) {
+        return _fail(error, quoted + " takes a number.");
+      }
+      const auto& k = ref.group == ParamGroup::primaryKnobs
+          ? plug.primaryKnobs[ref.idx]
+          : plug.secondaryKnobs[ref.idx];
+      *plug.getKnobValuePtr(id)
+          = std::clamp(signal_t(num), k.minVal, k.maxVal);
+      return true;
+    }
+    case ParamType::toggle: {
+      bool* p_val = plug.getToggleValuePtr(id);
+      if (value == "true" || value == "on") {
+        *p_val = true;
+      } else if (value == "false" || value == "off") {
+        *p_val = false;
+      } else if (_parseNumber(value, num)) {
+        *p_val = num != 0;
+      } else {
+        return _fail(error, quoted + " takes true or false.");
+      }
+      return true;
+    }
+    case ParamType::option: {
+      const auto& options = ref.group == ParamGroup::dropdowns
+          ? plug.dropdowns[ref.idx].options
+          : plug.radioButtons[ref.idx].options;
+      const int idx = _findOption(options, value);
+      if (idx < 0) {
+        return _fail(error, "Unknown option '" + std::string(value) + "' for "
+                + quoted + ".");
+      }
+      *plug.getOptionValuePtr(id) = idx;
+      return true;
+    }
+    }
+    return _fail(error, "Unknown parameter " + quoted + ".");
+  }
+}
+}
@@ -0,0 +1,467 @@
+#pragma once
+
+/**
+ * @file Wav.h
+ * @author Niels Thøgersen (niels.thoegersen@gmail.com)
+ * @brief Streaming WAV and raw float file IO for the renderer.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lib/Stereo.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace NtFx {
+namespace Wav {
+  static_assert(std::endian::native == std::endian::little,
+      "WAV files are little endian and are read without byte swapping.");
+
+  /**
+   * @brief Sample encoding of a file.
+   */
+  enum struct Encoding {
+    pcm8,
+    pcm16,
+    pcm24,
+    pcm32,
+    float32,
+    float64,
+  };
+
+  constexpr uint16_t formatPcm        = 1;
+  constexpr uint16_t formatFloat      = 3;
+  constexpr uint16_t formatExtensible = 0xfffe;
+
+  /**
+   * @brief Bytes per sample of an encoding.
+   */
+  constexpr size_t bytesPerSample(Encoding e) noexcept {
+    switch (e) {
+    case Encoding::pcm8:
+      return 1;
+    case Encoding::pcm16:
+      return 2;
+    case Encoding::pcm24:
+      return 3;
+    case Encoding::pcm32:
+    case Encoding::float32:
+      return 4;
+    case Encoding::float64:
+      return 8;
+    }
+    return 4;
+  }
+
+  /**
+   * @brief Files ending in '.raw' or '.f32' are headerless, interleaved
+   * float32.
+   */
+  inline bool isRaw(const std::string& path) {
+    auto endsWith = [&](const char* ext) {
+      const size_t n = std::strlen(ext);
+      return path.size() >= n && path.compare(path.size() - n, n, ext) == 0;
+    };
+    return endsWith(".raw") || endsWith(".f32");
+  }
+
+  /**
+   * @brief Decodes one sample to the range [-1, 1).
+   */
+  template <typename signal_t>
+  signal_t decode(const unsigned char* p, Encoding e) noexcept {
+    switch (e) {
+    case Encoding::pcm8:
+      return signal_t(int(p[0]) - 128) / signal_t(128);
+    case Encoding::pcm16: {
+      int16_t v;
+      std::memcpy(&v, p, 2);
+      return signal_t(v) / signal_t(32768);
+    }
+    case Encoding::pcm24: {
+      // Placed in the top of an int32 so the sign comes along.
+      int32_t v = int32_t(uint32_t(p[0]) << 8 | uint32_t(p[1]) << 16
+          | uint32_t(p[2]) << 24);
+      return signal_t(v >> 8) / signal_t(8388608);
+    }
+    case Encoding::pcm32: {
+      int32_t v;
+      std::memcpy(&v, p, 4);
+      return signal_t(double(v) / 2147483648.0);
+    }
+    case Encoding::float32: {
+      float v;
+      std::memcpy(&v, p, 4);
+      return signal_t(v);
+    }
+    case Encoding::float64: {
+      double v;
+      std::memcpy(&v, p, 8);
+      return signal_t(v);
+    }
+    }
+    return 0;
+  }
+
+  /**
+   * @brief Encodes one sample. Integer encodings are rounded and clipped.
+   */
+  template <typename signal_t>
+  void encode(signal_t x, unsigned char* p, Encoding e) noexcept {
+    auto toInt = [&](double scale) {
+      return int32_t(
+          std::clamp(std::round(double(x) * scale), -scale, scale - 1));
+    };
+    switch (e) {
+    case Encoding::pcm8:
+      p[0] = uint8_t(toInt(128) + 128);
+      return;
+    case Encoding::pcm16: {
+      int16_t v = int16_t(toInt(32768));
+      std::memcpy(p, &v, 2);
+      return;
+    }
+    case Encoding::pcm24: {
+      uint32_t v = uint32_t(toInt(8388608));
+      p[0]       = uint8_t(v);
+      p[1]       = uint8_t(v >> 8);
+      p[2]       = uint8_t(v >> 16);
+      return;
+    }
+    case Encoding::pcm32: {
+      int32_t v = toInt(2147483648.0);
+      std::memcpy(p, &v, 4);
+      return;
+    }
+    case Encoding::float32: {
+      float v = float(x);
+      std::memcpy(p, &v, 4);
+      return;
+    }
+    case Encoding::float64: {
+      double v = double(x);
+      std::memcpy(p, &v, 8);
+      return;
+    }
+    }
+  }
+
+  /**
+   * @brief Reads a WAV or raw float file in blocks. PCM of 8 to 32 bits and
+   * float of 32 and 64 bits are supported, including WAVE_FORMAT_EXTENSIBLE.
+   * Mono files are read to both channels. Files with more than two channels
+   * are read from the first two.
+   */
+  struct Reader {
+    std::ifstream file;
+    float fs { 48000 };
+    size_t nChannels { 2 };
+    size_t nFrames { 0 }; ///< Frames in the file.
+    size_t iFrame { 0 };  ///< Frames read so far.
+    Encoding encoding { Encoding::float32 };
+    std::vector<unsigned char> bytes;
+    std::string error; ///< Reason the last call failed.
+
+    /**
+     * @brief Opens a file and reads the header.
+     *
+     * @param path Path to a WAV file, or a raw file, see isRaw().
+     * @param fsRaw Sample rate of raw files.
+     * @param nChannelsRaw Number of channels of raw files.
+     * @return bool True on success. On failure, see 'error'.
+     */
+    bool open(const std::string& path, float fsRaw = 48000,
+        size_t nChannelsRaw = 2) {
+      this->file.open(path, std::ios::binary);
+      this->iFrame = 0;
+      if (!this->file) { return this->_fail("Could not open '" + path + "'."); }
+      if (isRaw(path)) {
+        this->fs        = fsRaw;
+        this->nChannels = std::max(nChannelsRaw, size_t(1));
+        this->encoding  = Encoding::float32;
+        this->file.seekg(0, std::ios::end);
+        const size_t nBytes = size_t(this->file.tellg());
+        this->file.seekg(0);
+        this->nFrames = nBytes / (4 * this->nChannels);
+        return true;
+      }
+      return this->_readHeader();
+    }
+
+    /**
+     * @brief Reads up to 'n' frames.
+     *
+     * @param x Output.
+     * @param n Frames wanted.
+     * @return size_t Frames read. Fewer than 'n' only at the end of the file.
+     */
+    template <typename signal_t>
+    size_t read(Stereo<signal_t>* x, size_t n) {
+      n = std::min(n, this->nFrames - this->iFrame);
+      const size_t nSample = bytesPerSample(this->encoding);
+      const size_t nFrame  = nSample * this->nChannels;
+      this->bytes.resize(n * nFrame);
+      this->file.read(
+          reinterpret_cast<char*>(this->bytes.data()), this->bytes.size());
+      n = size_t(this->file.gcount()) / nFrame;
+      const unsigned char* p = this->bytes.data();
+      const size_t iRight    = this->nChannels > 1 ? nSample : 0;
+      for (size_t i = 0; i < n; i++, p += nFrame) {
+        x[i] = { decode<signal_t>(p, this->encoding),
+          decode<signal_t>(p + iRight, this->encoding) };
+      }
+      this->iFrame += n;
+      return n;
+    }
+
+    bool _readHeader() {
+      unsigned char riff[12];
+      if (!this->_readBytes(riff, 12) || std::memcmp(riff, "RIFF", 4)
+          || std::memcmp(riff + 8, "WAVE", 4)) {
+        return this->_fail("Not a WAV file.");
+      }
+      bool hasFormat = false;
+      size_t nBlock  = 0;
+      while (true) {
+        unsigned char head[8];
+        if (!this->_readBytes(head, 8)) {
+          return this->_fail("No data chunk found.");
+        }
+        uint32_t size;
+        std::memcpy(&size, head + 4, 4);
+        if (!std::memcmp(head, "fmt ", 4)) {
+          unsigned char fmt[40] = {};
+          const size_t nFmt     = std::min(size_t(size), sizeof(fmt));
+          if (nFmt < 16 || !this->_readBytes(fmt, nFmt)) {
+            return this->_fail("Invalid fmt chunk.");
+          }
+          this->file.seekg(size - nFmt + (size & 1), std::ios::cur);
+          uint16_t format, nChannels, nBits, nBlockAlign;
+          uint32_t fs;
+          std::memcpy(&format, fmt, 2);
+          std::memcpy(&nChannels, fmt + 2, 2);
+          std::memcpy(&fs, fmt + 4, 4);
+          std::memcpy(&nBlockAlign, fmt + 12, 2);
+          std::memcpy(&nBits, fmt + 14, 2);
+          if (format == formatExtensible && nFmt >= 26) {
+            // The format tag is the start of the sub format GUID.
+            std::memcpy(&format, fmt + 24, 2);
+          }
+          if (!this->_setEncoding(format, nBits)) {
+            return this->_fail("Unsupported encoding: format "
+                + std::to_string(format) + ", " + std::to_string(nBits)
+                + " bits.");
+          }
+          if (nChannels == 0) { return this->_fail("No channels."); }
+          this->fs        = float(fs);
+          this->nChannels = nChannels;
+          nBlock    = std::max(size_t(nBlockAlign),
+              bytesPerSample(this->encoding) * this->nChannels);
+          hasFormat = true;
+        } else if (!std::memcmp(head, "data", 4)) {
+          if (!hasFormat) { return this->_fail("Data before fmt chunk."); }
+          // Writers that stream may leave the size unset. Read to the end.
+          const auto iData = this->file.tellg();
+          this->file.seekg(0, std::ios::end);
+          const size_t nLeft = size_t(this->file.tellg() - iData);
+          this->file.seekg(iData);
+          size_t nBytes = size == 0 || size == 0xffffffff
+              ? nLeft
+              : std::min(size_t(size), nLeft);
+          this->nFrames = nBytes / nBlock;
+          return true;
+        } else {
+          this->file.seekg(size + (size & 1), std::ios::cur);
+        }
+      }
+    }
+
+    bool _setEncoding(uint16_t format, uint16_t nBits) noexcept {
+      if (format == formatPcm) {
+        switch (nBits) {
+        case 8:
+          this->encoding = Encoding::pcm8;
+          return true;
+        case 16:
+          this->encoding = Encoding::pcm16;
+          return true;
+        case 24:
+          this->encoding = Encoding::pcm24;
+          return true;
+        case 32:
+          this->encoding = Encoding::pcm32;
+          return true;
+        }
+      }
+      if (format == formatFloat) {
+        switch (nBits) {
+        case 32:
+          this->encoding = Encoding::float32;
+          return true;
+        case 64:
+          this->encoding = Encoding::float64;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool _readBytes(unsigned char* p, size_t n) {
+      this->file.read(reinterpret_cast<char*>(p), n);
+      return size_t(this->file.gcount()) == n;
+    }
+
+    bool _fail(std::string msg) {
+      this->error = std::move(msg);
+      return false;
+    }
+  };
+
+  /**
+   * @brief Writes a WAV or raw float file in blocks. The sizes in the header
+   * are filled in by close(). Mono files get the mean of both channels.
+   */
+  struct Writer {
+    std::ofstream file;
+    bool raw { false };
+    size_t nChannels { 2 };
+    size_t nFrames { 0 }; ///< Frames written so far.
+    Encoding encoding { Encoding::float32 };
+    std::vector<unsigned char> bytes;
+    std::string error; ///< Reason the last call failed.
+
+    ~Writer() { this->close(); }
+
+    /**
+     * @brief Creates a file and writes a header.
+     *
+     * @param path Path to a WAV file, or a raw file, see isRaw(). Raw files
+     * are always float32.
+     * @param fs Sample rate.
+     * @param nChannels 1 or 2.
+     * @param encoding Sample encoding.
+     * @return bool True on success. On failure, see 'error'.
+     */
+    bool open(const std::string& path,
+        float fs,
+        size_t nChannels   = 2,
+        Encoding encoding = Encoding::float32) {
+      this->raw       = isRaw(path);
+      this->nChannels = std::clamp(nChannels, size_t(1), size_t(2));
+      this->encoding  = this->raw ? Encoding::float32 : encoding;
+      this->nFrames   = 0;
+      this->file.open(path, std::ios::binary | std::ios::trunc);
+      if (!this->file) {
+        this->error = "Could not create '" + path + "'.";
+        return false;
+      }
+      if (!this->raw) { this->_writeHeader(fs); }
+      return true;
+    }
+
+    /**
+     * @brief Writes 'n' frames.
+     *
+     * @param y Input.
+     * @param n Frames to write.
+     * @return bool True on success.
+     */
+    template <typename signal_t>
+    bool write(const Stereo<signal_t>* y, size_t n) {
+      const size_t nSample = bytesPerSample(this->encoding);
+      const size_t nFrame  = nSample * this->nChannels;
+      this->bytes.resize(n * nFrame);
+      unsigned char* p = this->bytes.data();
+      for (size_t i = 0; i < n; i++, p += nFrame) {
+        if (this->nChannels == 1) {
+          encode((y[i].l + y[i].r) / 2, p, this->encoding);
+        } else {
+          encode(y[i].l, p, this->encoding);
+          encode(y[i].r, p + nSample, this->encoding);
+        }
+      }
+      this->file.write(reinterpret_cast<const char*>(this->bytes.data()),
+          this->bytes.size());
+      this->nFrames += n;
+      if (!this->file) { this->error = "Write failed."; }
+      return bool(this->file);
+    }
+
+    /**
+     * @brief Fills in the header and closes the file.
+     *
+     * @return bool True on success.
+     */
+    bool close() {
+      if (!this->file.is_open()) { return true; }
+      if (!this->raw) {
+        const uint64_t nData = uint64_t(this->nFrames) * this->nChannels
+            * bytesPerSample(this->encoding);
+        // Sizes above 4 GB do not fit. They are left at the maximum, which
+        // most readers take as "read to the end".
+        const uint32_t size = uint32_t(std::min(nData, uint64_t(0xffffffff)));
+        const uint32_t sizeRiff
+            = uint32_t(std::min(nData + 36, uint64_t(0xffffffff)));
+        this->file.seekp(4);
+        this->_put32(sizeRiff);
+        this->file.seekp(40);
+        this->_put32(size);
+      }
+      this->file.close();
+      if (this->file.fail()) {
+        this->error = "Write failed.";
+        return false;
+      }
+      return true;
+    }
+
+    void _writeHeader(float fs) {
+      const bool isFloat = this->encoding == Encoding::float32
+          || this->encoding == Encoding::float64;
+      const uint16_t nBits = uint16_t(8 * bytesPerSample(this->encoding));
+      const uint16_t nBlock
+          = uint16_t(this->nChannels * bytesPerSample(this->encoding));
+      this->file.write("RIFF", 4);
+      this->_put32(0);
+      this->file.write("WAVEfmt ", 8);
+      this->_put32(16);
+      this->_put16(isFloat ? formatFloat : formatPcm);
+      this->_put16(uint16_t(this->nChannels));
+      this->_put32(uint32_t(std::lround(fs)));
+      this->_put32(uint32_t(std::lround(fs)) * nBlock);
+      this->_put16(nBlock);
+      this->_put16(nBits);
+      this->file.write("data", 4);
+      this->_put32(0);
+    }
+
+    void _put16(uint16_t v) {
+      this->file.write(reinterpret_cast<const char*>(&v), 2);
+    }
+
+    void _put32(uint32_t v) {
+      this->file.write(reinterpret_cast<const char*>(&v), 4);
+    }
+  };
+}
+}
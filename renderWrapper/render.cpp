@@ -0,0 +1,468 @@
+/*
+ * Copyright (C) 2026 Niels Thøgersen, NTlyd
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Headless renderer. Runs a plugin over an audio file without JUCE, through
+ * the same sample rate converter as the plugin wrapper.
+ **/
+
+#include NTFX_PLUGIN_FILE
+#include "lib/SampleRateConverter.h"
+#include "lib/Stereo.h"
+#include "lib/utils.h"
+#include "renderWrapper/Batch.h"
+#include "renderWrapper/Preset.h"
+#include "renderWrapper/Wav.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#define Q(x) #x
+#define QUOTE(x) Q(x)
+
+static const char* const usage
+    = "Usage: " QUOTE(NTFX_PLUGIN) "_render [options] <input> <output>\n"
+      "       " QUOTE(NTFX_PLUGIN) "_render [options] -d <dir> <input>...\n"
+      "\n"
+      "Renders <input> through " QUOTE(NTFX_PLUGIN) " to <output>, or each\n"
+      "<input> to a file of the same name in <dir>. Files are WAV, or\n"
+      "headerless interleaved float32 if named '.raw' or '.f32'.\n"
+      "\n"
+      "Options:\n"
+      "  -d, --out-dir <dir>     Batch mode. Renders all inputs to <dir>.\n"
+      "  -j, --jobs <n>          Files rendered in parallel in batch mode.\n"
+      "                          Defaults to the number of cores.\n"
+      "  -p, --preset <file>     Parameter values from a flat JSON object, or\n"
+      "                          from plugin state XML if named '.xml'.\n"
+      "  -s, --set <name=value>  Sets a parameter. Applied after the preset.\n"
+      "  -o, --oversampling <m>  Oversampling mode by name, e.g. 'hb_4x'.\n"
+      "  -t, --tempo <bpm>       Session tempo.\n"
+      "  -f, --format <f>        Output encoding: float32 (default), pcm16,\n"
+      "                          pcm24 or pcm32.\n"
+      "  -b, --block <n>         Block length in samples. Default 65536.\n"
+      "  -r, --rate <fs>         Sample rate of raw input. Default 48000.\n"
+      "  -c, --channels <n>      Channels of raw input. Default 2.\n"
+      "  --keep-latency          Do not remove the latency from the output.\n"
+      "  --no-tail               Stop at the end of the input.\n"
+      "  -l, --list              Lists the parameters and exits.\n"
+      "  -h, --help              Shows this message.\n";
+
+/**
+ * @brief Options given on the command line.
+ */
+struct Args {
+  std::vector<std::string> inPaths;
+  std::vector<std::string> outPaths;
+  std::string outDir;
+  size_t nJobs = std::max(std::thread::hardware_concurrency(), 1u);
+  NtFx::Preset::Values values;
+  NtFx::Wav::Encoding encoding = NtFx::Wav::Encoding::float32;
+  size_t blockLen              = 1 << 16;
+  float fsRaw                  = 48000;
+  size_t nChannelsRaw          = 2;
+  float tempo                  = 0;
+  bool compensateLatency       = true;
+  bool addTail                 = true;
+  bool list                    = false;
+};
+
+static bool fail(const std::string& msg) {
+  std::cerr << QUOTE(NTFX_PLUGIN) "_render: " << msg << std::endl;
+  return false;
+}
+
+/**
+ * @brief Names the outputs of batch mode after the inputs, in 'args.outDir'.
+ * Inputs that would overwrite each other, or themselves, are refused.
+ */
+static bool makeOutPaths(const std::vector<std::string>& files, Args& args) {
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  fs::create_directories(args.outDir, ec);
+  if (ec) { return fail("Could not create '" + args.outDir + "'."); }
+  std::set<std::string> names;
+  for (const auto& file : files) {
+    const auto name = fs::path(file).filename();
+    const auto out  = fs::path(args.outDir) / name;
+    if (!names.insert(name.string()).second) {
+      return fail("More than one input is named '" + name.string() + "'.");
+    }
+    if (fs::weakly_canonical(file, ec) == fs::weakly_canonical(out, ec)) {
+      return fail("'" + file + "' would be overwritten.");
+    }
+    args.inPaths.push_back(file);
+    args.outPaths.push_back(out.string());
+  }
+  return true;
+}
+
+static bool parseArgs(int argc, char** argv, Args& args) {
+  std::vector<std::string> files;
+  std::string error;
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg = argv[i];
+    auto next                  = [&](const char*& p_val) {
+      if (i + 1 >= argc) { return fail(std::string(arg) + " needs a value."); }
+      p_val = argv[++i];
+      return true;
+    };
+    auto nextNumber = [&](double& val) {
+      const char* p_val;
+      if (!next(p_val)) { return false; }
+      if (!NtFx::Preset::_parseNumber(p_val, val) || val <= 0) {
+        return fail(std::string(arg) + " takes a positive number.");
+      }
+      return true;
+    };
+    const char* p_val;
+    double num;
+    if (arg == "-h" || arg == "--help") {
+      std::cout << usage;
+      std::exit(0);
+    } else if (arg == "-p" || arg == "--preset") {
+      if (!next(p_val)) { return false; }
+      if (!NtFx::Preset::read(p_val, args.values, error)) {
+        return fail(error);
+      }
+    } else if (arg == "-s" || arg == "--set") {
+      if (!next(p_val)) { return false; }
+      if (!NtFx::Preset::parseAssignment(p_val, args.values, error)) {
+        return fail(error);
+      }
+    } else if (arg == "-d" || arg == "--out-dir") {
+      if (!next(p_val)) { return false; }
+      args.outDir = p_val;
+    } else if (arg == "-j" || arg == "--jobs") {
+      if (!nextNumber(num)) { return false; }
+      args.nJobs = size_t(num);
+    } else if (arg == "-o" || arg == "--oversampling") {
+      if (!next(p_val)) { return false; }
+      args.values.emplace_back(NtFx::Preset::oversamplingName, p_val);
+    } else if (arg == "-t" || arg == "--tempo") {
+      if (!nextNumber(num)) { return false; }
+      args.tempo = float(num);
+    } else if (arg == "-f" || arg == "--format") {
+      if (!next(p_val)) { return false; }
+      const std::string_view f = p_val;
+      if (f == "float32") {
+        args.encoding = NtFx::Wav::Encoding::float32;
+      } else if (f == "pcm16") {
+        args.encoding = NtFx::Wav::Encoding::pcm16;
+      } else if (f == "pcm24") {
+        args.encoding = NtFx::Wav::Encoding::pcm24;
+      } else if (f == "pcm32") {
+        args.encoding = NtFx::Wav::Encoding::pcm32;
+      } else {
+        return fail("Unknown format '" + std::string(f) + "'.");
+      }
+    } else if (arg == "-b" || arg == "--block") {
+      if (!nextNumber(num)) { return false; }
+      args.blockLen = size_t(num);
+    } else if (arg == "-r" || arg == "--rate") {
+      if (!nextNumber(num)) { return false; }
+      args.fsRaw = float(num);
+    } else if (arg == "-c" || arg == "--channels") {
+      if (!nextNumber(num)) { return false; }
+      args.nChannelsRaw = size_t(num);
+    } else if (arg == "--keep-latency") {
+      args.compensateLatency = false;
+    } else if (arg == "--no-tail") {
+      args.addTail = false;
+    } else if (arg == "-l" || arg == "--list") {
+      args.list = true;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      return fail("Unknown option '" + std::string(arg) + "'.\n\n" + usage);
+    } else {
+      files.emplace_back(arg);
+    }
+  }
+  if (args.list) { return true; }
+  if (args.outDir.empty()) {
+    if (files.size() != 2) { return fail(std::string("\n") + usage); }
+    args.inPaths  = { files[0] };
+    args.outPaths = { files[1] };
+    return true;
+  }
+  if (files.empty()) { return fail(std::string("\n") + usage); }
+  return makeOutPaths(files, args);
+}
+
+/**
+ * @brief Prints the parameters of the plugin with their ranges and defaults,
+ * for writing presets.
+ */
+template <typename signal_t>
+static void listParams(const NTFX_PLUGIN<signal_t>& plug) {
+  const auto& registry = plug.paramRegistry;
+  for (size_t id = 0; id < registry.size(); id++) {
+    const auto& ref = registry.refs[id];
+    std::cout << registry.names[id] << ": ";
+    switch (ref.type) {
+    case NtFx::ParamType::knob: {
+      const auto& k = ref.group == NtFx::ParamGroup::primaryKnobs
+          ? plug.primaryKnobs[ref.idx]
+          : plug.secondaryKnobs[ref.idx];
+      std::cout << k.minVal << " to " << k.maxVal << k.suffix << ", default "
+                << k._defaultVal;
+      break;
+    }
+    case NtFx::ParamType::toggle:
+      std::cout << "true or false, default "
+                << (*plug.getToggleValuePtr(int(id)) ? "true" : "false");
+      break;
+    case NtFx::ParamType::option: {
+      const auto& options = ref.group == NtFx::ParamGroup::dropdowns
+          ? plug.dropdowns[ref.idx].options
+          : plug.radioButtons[ref.idx].options;
+      for (size_t i = 0; i < options.size(); i++) {
+        std::cout << (i ? ", " : "") << options[i];
+      }
+      std::cout << ", default "
+                << options[*plug.getOptionValuePtr(int(id))];
+      break;
+    }
+    }
+    std::cout << "\n";
+  }
+  const NtFx::TitleBarSpec titleBar;
+  for (const auto& d : titleBar.dropdowns) {
+    if (d.name != NtFx::Preset::oversamplingName) { continue; }
+    std::cout << d.name << ": ";
+    for (size_t i = 0; i < d.options.size(); i++) {
+      std::cout << (i ? ", " : "") << d.options[i];
+    }
+    std::cout << ", default " << d.options[d._defaultVal] << "\n";
+  }
+}
+
+/**
+ * @brief Outcome of rendering one file.
+ */
+struct Result {
+  bool ok      = false;
+  size_t nIn   = 0; ///< Input frames.
+  size_t nOut  = 0; ///< Output frames.
+  float fs     = 0;
+  double t_s   = 0; ///< Wall time.
+  std::string error;
+};
+
+/**
+ * @brief A plugin with its sample rate converter. Batch mode has one per
+ * worker, which renders file after file.
+ */
+template <typename signal_t>
+struct Renderer {
+  NTFX_PLUGIN<signal_t> plug;
+  NtFx::Src::SampleRateConverter<signal_t> src;
+  std::vector<NtFx::Stereo<signal_t>> block;
+
+  Renderer() : src(plug) { this->src.mode = NtFx::Src::disable; }
+
+  /**
+   * @brief Applies the parameter values and the oversampling mode.
+   */
+  bool setup(const Args& args, std::string& error) {
+    this->block.resize(args.blockLen);
+    for (const auto& [name, value] : args.values) {
+      if (name == NtFx::Preset::oversamplingName) {
+        int mode = 0;
+        if (!NtFx::Preset::parseOversampling(value, mode, error)) {
+          return false;
+        }
+        this->src.mode = NtFx::Src::oversamplingMode(mode);
+      } else if (!NtFx::Preset::apply(this->plug, name, value, error)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Renders a file. The plugin and the converter are set up like in
+   * prepareToPlay() of the plugin wrapper, and the file is streamed through
+   * them in blocks of 'args.blockLen'. The latency of the converter and the
+   * plugin is removed from the start of the output, and the input is followed
+   * by silence for the tail of the plugin, so the output lines up with the
+   * input. Everything is reset first, including the random generator, so the
+   * output does not depend on the files rendered before it.
+   */
+  Result render(const Args& args, size_t iFile) {
+    const auto t0 = std::chrono::steady_clock::now();
+    Result res;
+    NtFx::Wav::Reader in;
+    if (!in.open(args.inPaths[iFile], args.fsRaw, args.nChannelsRaw)) {
+      res.error = in.error;
+      return res;
+    }
+    NtFx::Wav::Writer out;
+    const auto& outPath = args.outPaths[iFile];
+    if (!out.open(outPath, in.fs, in.nChannels, args.encoding)) {
+      res.error = out.error;
+      return res;
+    }
+    NtFx::seedRand();
+    this->src.reset(in.fs);
+    this->plug.reset(this->src.coeffs.fsHi);
+    if (args.tempo > 0) {
+      this->plug.tempo = args.tempo;
+      this->plug.onTempoChanged();
+    }
+    this->plug.update();
+
+    const size_t nLatency = args.compensateLatency
+        ? size_t(std::lround(this->src.getLatencySamples()))
+        : 0;
+    const size_t nTail = args.addTail
+        ? size_t(std::ceil(this->plug.getTailSeconds() * in.fs))
+        : 0;
+    // Input frames, then silence to flush the latency and the tail.
+    const size_t nTotal = in.nFrames + nLatency + nTail;
+    const size_t nBlock = this->block.size();
+    auto p_block        = this->block.data();
+    size_t nSkip        = nLatency;
+    for (size_t i0 = 0; i0 < nTotal; i0 += nBlock) {
+      const size_t n     = std::min(nBlock, nTotal - i0);
+      const size_t nRead = in.read(p_block, n);
+      std::fill(p_block + nRead, p_block + n, NtFx::Stereo<signal_t>(0));
+      this->src.processBlock(p_block, p_block, n);
+      const size_t nDrop = std::min(nSkip, n);
+      nSkip -= nDrop;
+      if (!out.write(p_block + nDrop, n - nDrop)) {
+        res.error = out.error;
+        return res;
+      }
+    }
+    if (!out.close()) {
+      res.error = out.error;
+      return res;
+    }
+    res.ok   = true;
+    res.nIn  = in.nFrames;
+    res.nOut = out.nFrames;
+    res.fs   = in.fs;
+    res.t_s  = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t0)
+                  .count();
+    return res;
+  }
+};
+
+/**
+ * @brief Renders all files on a work stealing thread pool with a renderer per
+ * worker. The longest files are started first. Prints a line per file as it
+ * completes and a summary with the throughput.
+ */
+template <typename signal_t>
+static bool renderAll(const Args& args) {
+  namespace fs         = std::filesystem;
+  const size_t nFiles  = args.inPaths.size();
+  const size_t nWorker = std::min(args.nJobs, nFiles);
+  std::vector<size_t> order(nFiles);
+  std::vector<uintmax_t> sizes(nFiles);
+  for (size_t i = 0; i < nFiles; i++) {
+    std::error_code ec;
+    order[i] = i;
+    sizes[i] = fs::file_size(args.inPaths[i], ec);
+  }
+  std::stable_sort(order.begin(), order.end(),
+      [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+  std::vector<std::unique_ptr<Renderer<signal_t>>> renderers(nWorker);
+  std::vector<Result> results(nFiles);
+  std::mutex printMutex;
+  const auto t0 = std::chrono::steady_clock::now();
+  NtFx::Batch::run(nFiles, nWorker, [&](size_t iWorker, size_t iJob) {
+    const size_t iFile = order[iJob];
+    auto& p_renderer   = renderers[iWorker];
+    auto& res          = results[iFile];
+    if (!p_renderer) {
+      // The parameters are checked by main(), so this does not fail.
+      p_renderer = std::make_unique<Renderer<signal_t>>();
+      p_renderer->setup(args, res.error);
+    }
+    res = p_renderer->render(args, iFile);
+    std::lock_guard<std::mutex> lock(printMutex);
+    if (!res.ok) {
+      fail(args.inPaths[iFile] + ": " + res.error);
+      return;
+    }
+    std::cout << "Rendered '" << args.inPaths[iFile] << "' to '"
+              << args.outPaths[iFile] << "': " << res.nOut << " frames at "
+              << res.fs << " Hz, " << res.nIn / res.fs / res.t_s
+              << "x realtime." << std::endl;
+  });
+  const double t_s = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - t0)
+                         .count();
+
+  size_t nOk = 0, nFrames = 0;
+  double tAudio_s = 0;
+  for (size_t i = 0; i < nFiles; i++) {
+    const auto& res = results[i];
+    if (!res.ok) { continue; }
+    nOk++;
+    nFrames += res.nIn;
+    tAudio_s += res.nIn / res.fs;
+  }
+  if (nFiles > 1) {
+    std::cout << "Rendered " << nOk << " of " << nFiles << " files on "
+              << nWorker << " workers in " << t_s << " s: "
+              << nFrames / t_s << " samples/s, " << tAudio_s / t_s
+              << "x realtime." << std::endl;
+  }
+#ifdef NTFX_PROFILE
+  NtFx::Profile::Table profile;
+  for (const auto& p_renderer : renderers) {
+    if (p_renderer) { profile.add(p_renderer->plug.profile); }
+  }
+  std::cout << "Profile of all files:\n";
+  profile.write(std::cout);
+#endif
+  return nOk == nFiles;
+}
+
+int main(int argc, char** argv) {
+  Args args;
+  if (!parseArgs(argc, argv, args)) { return 1; }
+  if (args.list) {
+    // Plugins are large, so they are kept off the stack.
+    auto p_plug = std::make_unique<NTFX_PLUGIN<float>>();
+    listParams(*p_plug);
+    return 0;
+  }
+  // Parameters are checked once up front rather than by every worker.
+  std::string error;
+  if (!std::make_unique<Renderer<float>>()->setup(args, error)) {
+    fail(error);
+    return 1;
+  }
+  return renderAll<float>(args) ? 0 : 1;
+}
+
+#undef Q
+#undef QUOTE
@@ -0,0 +1,58 @@
+#include "lib/Biquad.h"
+#include "lib/ComponentBench.h"
+#include <array>
+
+NTFX_BENCH_BEGIN
+
+/**
+ * @brief Eight EqBands in a chain, the way plugins ran several bands before
+ * Bank. Reference for bank8Serial.
+ */
+struct EqBandChain : public NtFx::Component<NtFx::Stereo<float>> {
+  std::array<NtFx::Biquad::EqBand<float>, 8> bands;
+
+  virtual NtFx::Stereo<float> process(
+      NtFx::Stereo<float> x) noexcept override {
+    for (auto& b : this->bands) { x = b.process(x); }
+    return x;
+  }
+
+  virtual void processBlock(const NtFx::Stereo<float>* x,
+      NtFx::Stereo<float>* y,
+      size_t n) noexcept override {
+    this->bands[0].processBlock(x, y, n);
+    for (size_t k = 1; k < this->bands.size(); k++) {
+      this->bands[k].processBlock(y, y, n);
+    }
+  }
+
+  virtual void reset(float fs) noexcept override {
+    this->fs = fs;
+    for (auto& b : this->bands) { b.reset(fs); }
+  }
+};
+
+NTFX_BENCH() {
+  auto eqBand             = NtFx::Biquad::EqBand<float>();
+  eqBand.settings.shape   = NtFx::Biquad::Shape::bell;
+  eqBand.settings.gain_db = 12;
+  eqBand.settings.fc_hz   = 4e3;
+  eqBand.settings.q       = 2;
+  NTFX_ADD_BENCH(eqBand);
+  auto biquad6             = NtFx::Biquad::BiQuad6Stereo<float>();
+  biquad6.settings.shape   = NtFx::Biquad::Shape::bell;
+  biquad6.settings.gain_db = 12;
+  biquad6.settings.fc_hz   = 4e3;
+  biquad6.settings.q       = 2;
+  NTFX_ADD_BENCH(biquad6);
+  auto eqBand8 = EqBandChain();
+  for (auto& b : eqBand8.bands) { b.settings = eqBand.settings; }
+  NTFX_ADD_BENCH(eqBand8);
+  auto bank8Serial = NtFx::Biquad::Bank<float, 8>();
+  for (auto& s : bank8Serial.settings) { s = eqBand.settings; }
+  NTFX_ADD_BENCH(bank8Serial);
+  auto bank8Parallel     = bank8Serial;
+  bank8Parallel.topology = NtFx::Biquad::Topology::parallel;
+  NTFX_ADD_BENCH(bank8Parallel);
+  return NTFX_RUN_BENCHES();
+}
@@ -0,0 +1,27 @@
+#include "lib/Comp.h"
+#include "lib/ComponentBench.h"
+
+NTFX_BENCH_BEGIN
+
+NTFX_BENCH() {
+  auto settings      = NtFx::Comp::ScSettings<float>();
+  settings.ratio_db  = 3;
+  settings.knee_db   = 6;
+  settings.thresh_db = -6;
+  settings.tAtt_ms   = 1;
+  settings.tRel_ms   = 20;
+  settings.tRms_ms   = 10;
+  auto peakDbSc      = NtFx::Comp::PeakSideChainDb<float>(settings);
+  NTFX_ADD_BENCH(peakDbSc);
+  auto peakLinSc = NtFx::Comp::PeakSideChainLinear<float>(settings);
+  NTFX_ADD_BENCH(peakLinSc);
+  auto rmsDbSc = NtFx::Comp::RmsSideChainDb<float>(settings);
+  NTFX_ADD_BENCH(rmsDbSc);
+  auto rmsLinSc = NtFx::Comp::RmsSideChainLinear<float>(settings);
+  NTFX_ADD_BENCH(rmsLinSc);
+  auto limiterSettings          = settings;
+  limiterSettings.tLookahead_ms = 2;
+  auto limiterSc = NtFx::Comp::LimiterSideChain<float>(limiterSettings);
+  NTFX_ADD_BENCH(limiterSc);
+  return NTFX_RUN_BENCHES();
+}
@@ -0,0 +1,11 @@
+#include "lib/ComponentBench.h"
+#include "lib/DynamicFilter.h"
+
+NTFX_BENCH_BEGIN
+
+NTFX_BENCH() {
+  auto shelf     = NtFx::DynamicFilter::Shelf<float>();
+  shelf.gain_lin = 0.5;
+  NTFX_ADD_BENCH(shelf);
+  return NTFX_RUN_BENCHES();
+}
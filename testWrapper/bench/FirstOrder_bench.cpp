@@ -0,0 +1,15 @@
+#include "lib/ComponentBench.h"
+#include "lib/FirstOrder.h"
+
+NTFX_BENCH_BEGIN
+
+NTFX_BENCH() {
+  auto lpf = NtFx::FirstOrder::Filter<float, NtFx::FirstOrder::Shape::lpf>();
+  lpf.fc_hz = 1e3;
+  NTFX_ADD_BENCH(lpf);
+  auto stereoHpf
+      = NtFx::FirstOrder::StereoFilter<float, NtFx::FirstOrder::Shape::hpf>();
+  stereoHpf.setFc(1e3);
+  NTFX_ADD_BENCH(stereoHpf);
+  return NTFX_RUN_BENCHES();
+}
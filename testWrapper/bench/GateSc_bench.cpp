@@ -0,0 +1,16 @@
+#include "lib/ComponentBench.h"
+#include "lib/GateSc.h"
+
+NTFX_BENCH_BEGIN
+
+NTFX_BENCH() {
+  auto settings      = NtFx::Gate::ScSettings<float>();
+  settings.thresh_db = -6;
+  settings.range_db  = -12;
+  settings.tHold_ms  = 10;
+  settings.tAtt_ms   = 5;
+  settings.tRel_ms   = 10;
+  auto gateSc        = NtFx::Gate::Sc<float>(settings);
+  NTFX_ADD_BENCH(gateSc);
+  return NTFX_RUN_BENCHES();
+}
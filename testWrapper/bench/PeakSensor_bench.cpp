@@ -0,0 +1,15 @@
+#include "lib/ComponentBench.h"
+#include "lib/PeakSensor.h"
+
+NTFX_BENCH_BEGIN
+
+NTFX_BENCH() {
+  auto peakSensor     = NtFx::PeakSensor<float>();
+  peakSensor.tPeak_ms = 20;
+  NTFX_ADD_BENCH(peakSensor);
+  auto peakHoldSensor     = NtFx::PeakHoldSensor<float>();
+  peakHoldSensor.tPeak_ms = 20;
+  peakHoldSensor.tHold_ms = 10;
+  NTFX_ADD_BENCH(peakHoldSensor);
+  return NTFX_RUN_BENCHES();
+}
@@ -0,0 +1,15 @@
+#include "lib/ComponentBench.h"
+#include "lib/RmsSensor.h"
+
+NTFX_BENCH_BEGIN
+
+NTFX_BENCH() {
+  auto rmsSensor = NtFx::RmsSensor<float>();
+  rmsSensor.setT_ms(10);
+  NTFX_ADD_BENCH(rmsSensor);
+  auto rmsSensorExp = NtFx::RmsSensor<float>();
+  rmsSensorExp.setT_ms(10);
+  rmsSensorExp.mode = NtFx::RmsMode::exponential;
+  NTFX_ADD_BENCH(rmsSensorExp);
+  return NTFX_RUN_BENCHES();
+}
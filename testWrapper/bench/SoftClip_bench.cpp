@@ -0,0 +1,12 @@
+#include "lib/ComponentBench.h"
+#include "lib/SoftClip.h"
+
+NTFX_BENCH_BEGIN
+
+NTFX_BENCH() {
+  auto third = NtFx::SoftClip3<float>();
+  NTFX_ADD_BENCH(third);
+  auto fifth = NtFx::SoftClip5<float>();
+  NTFX_ADD_BENCH(fifth);
+  return NTFX_RUN_BENCHES();
+}
@@ -0,0 +1,10 @@
+#include "lib/ComponentBench.h"
+#include "lib/Transformer.h"
+
+NTFX_BENCH_BEGIN
+
+NTFX_BENCH() {
+  auto transformer = NtFx::Transformer<float>();
+  NTFX_ADD_BENCH(transformer);
+  return NTFX_RUN_BENCHES();
+}
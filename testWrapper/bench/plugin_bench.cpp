@@ -0,0 +1,38 @@
+/**
+ * Benchmarks a plugin at every oversampling mode, as the JUCE wrapper runs it.
+ * Built once per plugin by 'test.py bench' with NTFX_PLUGIN and
+ * NTFX_PLUGIN_FILE set to the plugin.
+ */
+
+#include "lib/ComponentBench.h"
+#include "lib/SampleRateConverter.h"
+#include "lib/UiSpec.h"
+
+NTFX_BENCH() {
+  using stereo_t         = NtFx::Stereo<float>;
+  auto componentBenchSet = NtFx::ComponentBenchSet(
+      _NTFX_BENCH_EXPAND_AND_QUOTE(NTFX_PLUGIN));
+  NTFX_PLUGIN<float> plug;
+  NtFx::Src::SampleRateConverter<float> src(plug);
+  const NtFx::TitleBarSpec titleBar;
+  for (const auto& d : titleBar.dropdowns) {
+    if (d.name != "Oversampling") { continue; }
+    for (size_t i = 0; i < d.options.size(); i++) {
+      // Drop down IDs start at 1, which is also the first mode.
+      const auto mode = NtFx::Src::oversamplingMode(i + 1);
+      auto reset      = [&plug, &src, mode]() {
+        src.mode = mode;
+        src.reset(NTFX_FS);
+        plug.reset(src.coeffs.fsHi);
+        plug.update();
+      };
+      auto process = [&src](stereo_t x) { return src.process(x); };
+      auto processBlock = [&src](const stereo_t* x, stereo_t* y, size_t n) {
+        src.processBlock(x, y, n);
+      };
+      componentBenchSet.add<stereo_t>(
+          d.options[i], reset, process, processBlock);
+    }
+  }
+  return NTFX_RUN_BENCHES();
+}
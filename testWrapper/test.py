@@ -21,8 +21,10 @@ import os
 import subprocess as sp
 import sys
 import argparse
+import csv
 import shutil
 import platform
+import struct
 import numpy as np
 from matplotlib import pyplot as p
 from scipy import signal as s
@@ -30,6 +32,16 @@ from scipy import signal as s
 SEPARATOR = "."
 EXPECTED_DIR = "in"
 TMP_DIR = "out"
+BENCH_DIR = "bench"
+BENCH_CSV = "bench.csv"
+PLUGIN_BENCH = "plugin_bench.cpp"
+BENCH_BASELINE = "baseline.csv"
+BENCH_RESULTS = "benchResults.txt"
+# A benchmark has regressed when its median is more than the tolerance above
+# the baseline and the difference is more than this many (scaled) MADs.
+BENCH_N_MADS = 3
+# Scales a median absolute deviation to a standard deviation for normal noise.
+MAD_TO_STD = 1.4826
 STIMULI = [
     "impulse",
     "linearSweep",
@@ -38,6 +50,12 @@ STIMULI = [
     "dynamic_matched",
 ]
 FILE_DIR = os.path.dirname(__file__)
+VECTOR_EXT = ".f64"
+TEXT_EXT = ".txt"
+# Matches TestVector::Header in lib/TestVector.h.
+VECTOR_HEADER = struct.Struct("<4sIIIQ")
+VECTOR_MAGIC = b"NTTV"
+VECTOR_VERSION = 1
 
 
 def generateImpulse(n: int) -> np.ndarray:
@@ -135,18 +153,91 @@ def generateLinearSweep(fs: float, t: float) -> np.ndarray:
     return s.chirp(tAx, 20, t, 20e3)
 
 
-def _storeMonoTestVectorAsStereo(x: np.ndarray, filename: str):
-    with open(filename, "w", encoding="utf8") as f:
-        for sample in x:
-            f.write(str(sample) + " " + str(sample) + "\n")
+def writeVector(x: np.ndarray, path: str):
+    """
+    Stores a stereo vector in the binary format read by ComponentTest: a 24
+    byte header followed by interleaved little endian float64 samples.
+
+    Args:
+        x (np.ndarray): Data to store, shape [2, n].
+        path (str): Output path.
+    """
+    with open(path, "wb") as f:
+        nFrames = x.shape[1]
+        f.write(VECTOR_HEADER.pack(VECTOR_MAGIC, VECTOR_VERSION, 2, 0, nFrames))
+        f.write(np.ascontiguousarray(x.T, dtype="<f8").tobytes())
+
+
+def readVector(path: str) -> np.ndarray | None:
+    """
+    Reads a stereo vector. Binary files are memory mapped, text files with two
+    columns are parsed.
+
+    Args:
+        path (str): Path of file.
+
+    Returns:
+        np.ndarray | None: Data of shape [2, n] or None if the file is not a
+        test vector.
+    """
+    if path.endswith(TEXT_EXT):
+        return np.loadtxt(path, ndmin=2).T
+    with open(path, "rb") as f:
+        header = f.read(VECTOR_HEADER.size)
+    if len(header) != VECTOR_HEADER.size:
+        print(f"'{path}' is too short for a header.")
+        return None
+    magic, version, nChannels, _, nFrames = VECTOR_HEADER.unpack(header)
+    if magic != VECTOR_MAGIC or version != VECTOR_VERSION or nChannels != 2:
+        print(f"'{path}' is not a stereo test vector.")
+        return None
+    if not nFrames:
+        return np.zeros([2, 0])
+    x = np.memmap(
+        path,
+        dtype="<f8",
+        mode="r",
+        offset=VECTOR_HEADER.size,
+        shape=(nFrames, nChannels),
+    )
+    return x.T
 
 
 def _storeStereoTestVector(x: np.ndarray, filename: str):
-    with open(filename, "w", encoding="utf8") as f:
-        xL = x[0, :]
-        xR = x[1, :]
-        for i, _ in enumerate(xL):
-            f.write(f"{xL[i]:.16f} {xR[i]:.16f}\n")
+    writeVector(x, filename)
+    textPath = filename.replace(VECTOR_EXT, TEXT_EXT)
+    if os.path.exists(textPath):
+        os.remove(textPath)
+
+
+def convertVectors(keepText: bool = False) -> int:
+    """
+    Converts all text vectors in the input dir to the binary format. Where
+    both exist, the binary vector is kept, as ComponentTest reads that one.
+
+    Args:
+        keepText (bool, optional): Keep the text files. Defaults to False.
+
+    Returns:
+        int: Number of files converted.
+    """
+    n = 0
+    inDir = f"{FILE_DIR}/{EXPECTED_DIR}"
+    if not os.path.isdir(inDir):
+        return 0
+    for file in sorted(os.listdir(inDir)):
+        if not file.endswith(TEXT_EXT):
+            continue
+        textPath = f"{inDir}/{file}"
+        binPath = textPath[: -len(TEXT_EXT)] + VECTOR_EXT
+        if not os.path.exists(binPath):
+            writeVector(readVector(textPath), binPath)
+            n += 1
+        if not keepText:
+            os.remove(textPath)
+    if n:
+        print(f"Converted {n} text vectors in `{EXPECTED_DIR}` to binary.")
+    return n
 
 
 def generateTestVectors(
@@ -168,26 +259,33 @@ def generateTestVectors(
     outputPath = f"{FILE_DIR}/{EXPECTED_DIR}/"
     _impulse = generateImpulse(n)
     impulse = np.vstack((_impulse, _impulse))
-    _storeStereoTestVector(impulse, outputPath + "impulse.txt")
+    _storeStereoTestVector(impulse, outputPath + "impulse" + VECTOR_EXT)
     steppedSineL = generateBurstSine(fs, t, 10e3, 2, 0.25, 1)
     steppedSineR = generateBurstSine(fs, t, 10e3, 2, 1, 0.25)
     dynamic_alternating = np.array([steppedSineL, steppedSineR])
     _storeStereoTestVector(
-        dynamic_alternating, outputPath + "dynamic_alternating.txt"
+        dynamic_alternating, outputPath + "dynamic_alternating" + VECTOR_EXT
     )
     dynamic_matched = np.array([steppedSineL, steppedSineL])
-    _storeStereoTestVector(dynamic_matched, outputPath + "dynamic_matched.txt")
+    _storeStereoTestVector(
+        dynamic_matched, outputPath + "dynamic_matched" + VECTOR_EXT
+    )
     _syncSweep = generateSyncSweep()
     syncSweep = np.array([_syncSweep, _syncSweep])
-    _storeStereoTestVector(syncSweep, outputPath + "syncSweep.txt")
+    _storeStereoTestVector(syncSweep, outputPath + "syncSweep" + VECTOR_EXT)
     _linearSweep = generateLinearSweep(fs, 1)
     linearSweep = np.array([_linearSweep, _linearSweep])
-    _storeStereoTestVector(linearSweep, outputPath + "linearSweep.txt")
+    _storeStereoTestVector(
+        linearSweep, outputPath + "linearSweep" + VECTOR_EXT
+    )
     return (impulse, linearSweep, syncSweep, dynamic_alternating)
 
 
-def _buildTestProg(cppPath: str) -> bool:
+def _buildTestProg(
+    cppPath: str, optimize: bool = False, defines: list[str] | None = None
+) -> bool:
     os.makedirs(f"{FILE_DIR}/{TMP_DIR}", exist_ok=True)
+    defines = ["NTFX_FS=48e3f"] + (defines or [])
     args = ["g++"]
     if platform.system() == "macOS":
         args = ["clang++"]
@@ -198,9 +296,9 @@ def _buildTestProg(cppPath: str) -> bool:
         f"-I{os.path.abspath(FILE_DIR)}/..",
         f"-I{os.path.abspath(FILE_DIR)}/../lib/gcem/include",
         "--std=c++20",
-        "-DNTFX_FS=48e3f",
-        "-O0",
     ]
+    args += [f"-D{define}" for define in defines]
+    args += ["-O3", "-DNDEBUG"] if optimize else ["-O0"]
     if platform.system() == "Windows":
         args = [
             "cl.exe",
@@ -209,9 +307,10 @@ def _buildTestProg(cppPath: str) -> bool:
             f"/I{os.path.abspath(FILE_DIR)}{os.sep}..{os.sep}",
             f"/I{os.path.abspath(FILE_DIR)}{os.sep}..{os.sep}lib{os.sep}gcem{os.sep}include",
             "/std:c++20",
-            "/DNTFX_FS=48e3f",
             "/EHsc",
         ]
+        args += [f"/D{define}" for define in defines]
+        args += ["/O2", "/DNDEBUG"] if optimize else []
     res = sp.run(
         args,
         check=False,
@@ -222,9 +321,9 @@ def _buildTestProg(cppPath: str) -> bool:
     return True
 
 
-def _runTestProg() -> int:
+def _runTestProg(args: list[str] | None = None) -> int:
     res = sp.run(
-        [f"{FILE_DIR}/{TMP_DIR}/main"],
+        [f"{FILE_DIR}/{TMP_DIR}/main"] + (args or []),
         check=False,
     )
     return res.returncode
@@ -462,9 +561,12 @@ def _parseFiles(files: list[str], exceptedFiles: list[str]):
             continue
         legends = ["result left", "result right"]
         if info[0] + SEPARATOR + info[1] in exceptedFiles:
-            excepted = _readResult(
+            expectedPath = (
                 f"{FILE_DIR}/{EXPECTED_DIR}/{file.replace("result", "expected")}"
             )
+            if not os.path.exists(expectedPath):
+                expectedPath = expectedPath.replace(VECTOR_EXT, TEXT_EXT)
+            excepted = _readResult(expectedPath)
             if excepted is not None:
                 legends = [
                     "expected left",
@@ -489,14 +591,7 @@ def _readResult(path: str) -> np.ndarray | None:
     if not os.path.exists(path):
         print(f"Bad path: {path}")
         return None
-    with open(path, "r", encoding="utf8") as f:
-        lines = f.readlines()
-    y = np.zeros([2, len(lines)])
-    for i, line in enumerate(lines):
-        vs = line.split(" ")
-        y[0, i] = vs[0]
-        y[1, i] = vs[1]
-    return y
+    return readVector(path)
 
 
 def _plotResults(
@@ -546,13 +641,15 @@ def _readAndPlotTestResults(testFileName: str, fs: float):
     outFiles = os.listdir(f"{FILE_DIR}/{TMP_DIR}")
     for file in outFiles:
         if file.startswith(testFileName) and file.endswith(
-            f"{SEPARATOR}result.txt"
+            f"{SEPARATOR}result{VECTOR_EXT}"
         ):
             resultFiles += [file]
     expectedFiles: list[str] = []
     inFiles = os.listdir(f"{FILE_DIR}/{EXPECTED_DIR}")
     for file in inFiles:
-        if file.endswith(f"{SEPARATOR}expected.txt"):
+        if file.endswith(f"{SEPARATOR}expected{VECTOR_EXT}") or file.endswith(
+            f"{SEPARATOR}expected{TEXT_EXT}"
+        ):
             info = file.split(SEPARATOR)
             if len(info) != 5:
                 print(f"Bad filename: {file}")
@@ -578,7 +675,7 @@ def acceptLatestResult(files: list[str], objects: list[str]) -> bool:
     resultFiles = os.listdir(f"{FILE_DIR}/{TMP_DIR}")
     filesToCopy: list[str] = []
     for file in resultFiles:
-        if file.endswith(f"{SEPARATOR}result.txt"):
+        if file.endswith(f"{SEPARATOR}result{VECTOR_EXT}"):
             info = file.split(SEPARATOR)
             if len(info) != 5:
                 print(f"Bad filename: {file}")
@@ -592,12 +689,13 @@ def acceptLatestResult(files: list[str], objects: list[str]) -> bool:
         print("No result files found.")
         return False
     for file in filesToCopy:
-        storeFile = file.replace("result", "expected")
-        with open(f"{FILE_DIR}/{TMP_DIR}/" + file, "r", encoding="utf8") as x:
-            with open(
-                f"{FILE_DIR}/{EXPECTED_DIR}/" + storeFile, "w", encoding="utf8"
-            ) as y:
-                y.write(x.read())
+        storePath = f"{FILE_DIR}/{EXPECTED_DIR}/" + file.replace(
+            "result", "expected"
+        )
+        shutil.copyfile(f"{FILE_DIR}/{TMP_DIR}/" + file, storePath)
+        textPath = storePath.replace(VECTOR_EXT, TEXT_EXT)
+        if os.path.exists(textPath):
+            os.remove(textPath)
     print(f"Copied {len(filesToCopy)} files with expected results to `in`.")
     return True
 
@@ -636,9 +734,9 @@ def runTests(path: str, fs: float) -> bool:
     return returncode == 0
 
 
-def _readAggregateResults() -> dict[str, int]:
+def _readAggregateResults(fileName: str = "results.txt") -> dict[str, int]:
     results = {}
-    path = f"{FILE_DIR}/{TMP_DIR}/results.txt"
+    path = f"{FILE_DIR}/{TMP_DIR}/{fileName}"
     if not os.path.exists(path):
         return {}
     with open(path, encoding="utf8") as f:
@@ -681,6 +779,7 @@ def run(args: dict):
     os.makedirs(f"{FILE_DIR}/{EXPECTED_DIR}", exist_ok=True)
     os.makedirs(f"{FILE_DIR}/{TMP_DIR}", exist_ok=True)
     clean()
+    convertVectors()
     success = True
     files = args["files"]
     if not files or files == ["all"]:
@@ -715,6 +814,193 @@ def run(args: dict):
     return success
 
 
+def _findAllBenches() -> list[str]:
+    paths = []
+    for file in sorted(os.listdir(f"{FILE_DIR}/{BENCH_DIR}")):
+        if file.endswith("_bench.cpp") and file != PLUGIN_BENCH:
+            paths += [f"{FILE_DIR}/{BENCH_DIR}/" + file]
+    return paths
+
+
+def _findAllPlugins() -> list[str]:
+    plugins = []
+    for file in sorted(os.listdir(f"{FILE_DIR}/../plugins")):
+        if file.endswith(".h"):
+            plugins += [file.replace(".h", "")]
+    return plugins
+
+
+def runBench(path: str, plugin: str | None = None, runs: int = 5) -> bool:
+    """
+    Builds and runs a benchmark program with optimization. Results are
+    appended to the benchmark CSV file in the output dir.
+
+    Args:
+        path (str): Path to the benchmark cpp file.
+        plugin (str | None, optional): Plugin to build the plugin benchmark
+            for. Defaults to None.
+        runs (int, optional): Number of times to time each benchmark.
+            Defaults to 5.
+
+    Returns:
+        bool: True on success.
+    """
+    defines = []
+    name = os.path.basename(path).replace("_bench.cpp", "")
+    if plugin:
+        name = plugin
+        defines = [
+            f"NTFX_PLUGIN={plugin}",
+            f'NTFX_PLUGIN_FILE="plugins/{plugin}.h"',
+        ]
+    print(f"Benchmarking '{name}'")
+    if not _buildTestProg(path, True, defines):
+        return False
+    return _runTestProg(["--runs", str(runs)]) == 0
+
+
+def _readBenchCsv(path: str) -> dict[tuple[str, str, str], dict[str, float]]:
+    results = {}
+    with open(path, encoding="utf8", newline="") as f:
+        for row in csv.DictReader(f):
+            key = (row["set"], row["object"], row["method"])
+            results[key] = {
+                "ns": float(row["ns_per_sample"]),
+                "mad": float(row["mad_ns"]),
+            }
+    return results
+
+
+def compareBench(
+    resultsPath: str, baselinePath: str, tolerance: float
+) -> bool:
+    """
+    Compares benchmark results to a baseline. A benchmark fails if its median
+    time per sample is more than 'tolerance' above the baseline and the
+    difference is larger than the noise of both, estimated from their median
+    absolute deviations. The outcome of each benchmark file is written to the
+    bench results file in the output dir, in the format of 'results.txt'.
+
+    Args:
+        resultsPath (str): Benchmark results as written by ComponentBench.
+        baselinePath (str): Baseline in the same format.
+        tolerance (float): Accepted slow down, e.g. 0.1 for 10 %.
+
+    Returns:
+        bool: True if no benchmark has regressed.
+    """
+    results = _readBenchCsv(resultsPath)
+    baseline = _readBenchCsv(baselinePath)
+    sets: dict[str, dict] = {}
+    success = True
+    for key, res in results.items():
+        benchSet = sets.setdefault(
+            key[0], {"nBenches": 0, "objects": set(), "nWithin": 0}
+        )
+        benchSet["nBenches"] += 1
+        benchSet["objects"].add(key[1])
+        name = SEPARATOR.join(key)
+        if key not in baseline:
+            print(f"No baseline for '{name}'.")
+            benchSet["nWithin"] += 1
+            continue
+        base = baseline[key]
+        change = res["ns"] / base["ns"] - 1
+        noise = MAD_TO_STD * (res["mad"] ** 2 + base["mad"] ** 2) ** 0.5
+        if change > tolerance and res["ns"] - base["ns"] > BENCH_N_MADS * noise:
+            print(
+                "\033[31m"
+                + f"'{name}' regressed: {res['ns']:.2f} ns/sample, baseline "
+                + f"{base['ns']:.2f} ns/sample ({100 * change:+.1f} %)."
+                + "\033[0m"
+            )
+            success = False
+            continue
+        if change < -tolerance:
+            print(f"'{name}' is {-100 * change:.1f} % faster than baseline.")
+        benchSet["nWithin"] += 1
+    with open(
+        f"{FILE_DIR}/{TMP_DIR}/{BENCH_RESULTS}", "w", encoding="utf8"
+    ) as f:
+        for name, benchSet in sets.items():
+            f.write(
+                f"{name},{benchSet['nBenches']},{len(benchSet['objects'])},"
+                f"{benchSet['nWithin']}\n"
+            )
+    return success
+
+
+def bench(args: dict) -> bool:
+    """
+    Runs benchmarks of library components and of plugins at every
+    oversampling mode.
+
+    Args:
+        args (dict): Used to get 'names', 'runs', 'tolerance', 'baseline' and
+            'approve' from the command line.
+
+    Returns:
+        bool: True on success. False if a benchmark failed to build or run, or
+        is slower than the baseline.
+    """
+    os.makedirs(f"{FILE_DIR}/{TMP_DIR}", exist_ok=True)
+    convertVectors()
+    csvPath = f"{FILE_DIR}/{TMP_DIR}/{BENCH_CSV}"
+    if os.path.exists(csvPath):
+        os.remove(csvPath)
+    names = args["names"]
+    benches = _findAllBenches()
+    plugins = _findAllPlugins()
+    if names and names != ["all"]:
+        selected = []
+        for name in names:
+            name = name.replace("_bench", "").replace(".cpp", "")
+            path = f"{FILE_DIR}/{BENCH_DIR}/{name}_bench.cpp"
+            if path in benches:
+                selected += [path]
+            elif name not in plugins:
+                print(f"No benchmark or plugin named '{name}'. Skipping.")
+        plugins = [plugin for plugin in plugins if plugin in names]
+        benches = selected
+    resultsPath = f"{FILE_DIR}/{TMP_DIR}/{BENCH_RESULTS}"
+    if os.path.exists(resultsPath):
+        os.remove(resultsPath)
+    runs = args["runs"]
+    success = True
+    for path in benches:
+        success &= runBench(path, None, runs)
+        print()
+    for plugin in plugins:
+        success &= runBench(
+            f"{FILE_DIR}/{BENCH_DIR}/{PLUGIN_BENCH}", plugin, runs
+        )
+        print()
+    if not os.path.exists(csvPath):
+        print("No benchmark results.")
+        return False
+    print(f"Results written to '{csvPath}'.")
+    baselinePath = args["baseline"]
+    if args["approve"]:
+        shutil.copyfile(csvPath, baselinePath)
+        print(f"Stored results as baseline in '{baselinePath}'.")
+        return success
+    if not os.path.exists(baselinePath):
+        print(f"No baseline at '{baselinePath}'. Store one with --approve.")
+        return success
+    success &= compareBench(csvPath, baselinePath, args["tolerance"])
+    results = _readAggregateResults(BENCH_RESULTS)
+    print(
+        f"Compared {results["nTests"]} benchmarks of {results["nObjects"]} "
+        f"objects in {results["nFiles"]} files to baseline. "
+        f"{results["nSuccessful"]} within {100 * args["tolerance"]:.0f} %."
+    )
+    if success:
+        print("\033[32mBENCHMARKS PASSED\033[0m")
+    else:
+        print("\033[31mBENCHMARKS FAILED\033[0m")
+    return success
+
+
 def createParser() -> argparse.ArgumentParser:
     """
     Creates an argument parser for test program.
@@ -738,12 +1024,59 @@ def createParser() -> argparse.ArgumentParser:
         help="Cpp-files to run. If 'all' or nothing, dir 'test' will be searched"
         " for files ending with '_test.cpp' and those will be used.",
     )
+    benchParser = subparsers.add_parser(
+        "bench",
+        help="Run benchmarks with optimization. A list of names can be added "
+        "to select specific benchmarks or plugins.",
+    )
+    benchParser.add_argument(
+        "names",
+        nargs="*",
+        type=str,
+        help="Benchmarks in dir 'bench' or plugins to run. If 'all' or "
+        "nothing, all benchmarks and all plugins are run.",
+    )
+    benchParser.add_argument(
+        "--runs",
+        "-r",
+        type=int,
+        default=5,
+        help="Number of times each benchmark is timed. The median is compared "
+        "to the baseline. Defaults to 5.",
+    )
+    benchParser.add_argument(
+        "--tolerance",
+        type=float,
+        default=0.1,
+        help="Accepted slow down relative to baseline. Defaults to 0.1.",
+    )
+    benchParser.add_argument(
+        "--baseline",
+        type=str,
+        default=f"{FILE_DIR}/{BENCH_DIR}/{BENCH_BASELINE}",
+        help="Baseline to compare to. Defaults to 'bench/baseline.csv'.",
+    )
+    benchParser.add_argument(
+        "--approve",
+        action="store_true",
+        help="Store the results as new baseline instead of comparing.",
+    )
     generateParser = subparsers.add_parser(
         "generate", help="Generate needed input files."
     )
     subparsers.add_parser(
         "clean", help="Cleans all outputs from previous tests."
     )
+    convertParser = subparsers.add_parser(
+        "convert",
+        help="Convert text vectors in input dir to binary. 'run' does this "
+        "automatically.",
+    )
+    convertParser.add_argument(
+        "--keep-text",
+        action="store_true",
+        help="Keep the text files after conversion.",
+    )
     approveParser = subparsers.add_parser(
         "approve", help="Set selected results in output dir as new expected."
     )
@@ -790,8 +1123,13 @@ def main(args: dict) -> bool:
         return generateTestVectors(t, fs) is not None
     if args["test_task"] == "run":
         return run(args)
+    if args["test_task"] == "bench":
+        return bench(args)
     if args["test_task"] == "clean":
         return clean()
+    if args["test_task"] == "convert":
+        convertVectors(args["keep_text"])
+        return True
     if args["test_task"] == "approve":
         return acceptLatestResult(args["file"], args["objects"])
     print(f"Unknown command: '{args['task']}'.")
@@ -0,0 +1,90 @@
+
+
+#include "lib/Biquad.h"
+#include "lib/ComponentTest.h"
+#include <iterator>
+#include <vector>
+
+NTFX_TEST_BEGIN
+
+/**
+ * @brief Bands of different shapes. The expected vectors are a chain of
+ * EqBands with the same settings, and the sum of them for the parallel bank.
+ */
+template <typename signal_t, size_t nBands>
+void setBands(NtFx::Biquad::Bank<signal_t, nBands>& bank) {
+  using NtFx::Biquad::Shape;
+  const Shape shapes[] = {
+    Shape::bell,
+    Shape::hpf,
+    Shape::lpf,
+    Shape::loShelf,
+    Shape::hiShelf,
+    Shape::bell,
+    Shape::bell,
+    Shape::bell,
+  };
+  const double fc_hz[]   = { 4e3, 100, 10e3, 200, 2e3, 1e3, 300, 8e3 };
+  const double gain_db[] = { 12, 0, 0, 12, -12, -6, 3, 6 };
+  const double q[]       = { 2, 0.707, 0.707, 0.707, 0.707, 1, 0.5, 4 };
+  static_assert(nBands <= std::size(shapes));
+  for (size_t k = 0; k < nBands; k++) {
+    bank.settings[k] = { shapes[k], signal_t(fc_hz[k]), signal_t(gain_db[k]),
+      signal_t(q[k]) };
+  }
+}
+
+/**
+ * @brief A float bank, so processBlock() takes the SIMD path with several
+ * bands per register. The test alternates process() and processBlock() and
+ * compares both to the chain of double precision EqBands.
+ */
+template <size_t nBands>
+struct FloatBank : public NtFx::Component<NtFx::Stereo<double>> {
+  NtFx::Biquad::Bank<float, nBands> bank;
+  std::vector<NtFx::Stereo<float>> buffer;
+
+  FloatBank(NtFx::Biquad::Topology topology) {
+    this->bank.topology = topology;
+    setBands(this->bank);
+  }
+
+  virtual NtFx::Stereo<double> process(
+      NtFx::Stereo<double> x) noexcept override {
+    const auto y = this->bank.process({ float(x.l), float(x.r) });
+    return { y.l, y.r };
+  }
+
+  virtual void processBlock(const NtFx::Stereo<double>* x,
+      NtFx::Stereo<double>* y,
+      size_t n) noexcept override {
+    this->buffer.resize(n);
+    for (size_t i = 0; i < n; i++) {
+      this->buffer[i] = { float(x[i].l), float(x[i].r) };
+    }
+    this->bank.processBlock(this->buffer.data(), this->buffer.data(), n);
+    for (size_t i = 0; i < n; i++) {
+      y[i] = { this->buffer[i].l, this->buffer[i].r };
+    }
+  }
+
+  virtual void reset(float fs) noexcept override {
+    this->fs = fs;
+    this->bank.reset(fs);
+  }
+};
+
+NTFX_TEST() {
+  auto serial = NtFx::Biquad::Bank<double, 5>();
+  setBands(serial);
+  NTFX_ADD_TEST(serial, "impulse");
+  auto parallel     = NtFx::Biquad::Bank<double, 5>();
+  parallel.topology = NtFx::Biquad::Topology::parallel;
+  setBands(parallel);
+  NTFX_ADD_TEST(parallel, "impulse");
+  auto serialFloat = FloatBank<8>(NtFx::Biquad::Topology::serial);
+  NTFX_ADD_TEST(serialFloat, "impulse");
+  auto parallelFloat = FloatBank<8>(NtFx::Biquad::Topology::parallel);
+  NTFX_ADD_TEST(parallelFloat, "impulse");
+  return NTFX_RUN_TESTS();
+}
@@ -0,0 +1,23 @@
+
+
+#include "lib/ComponentTest.h"
+#include "lib/DelayLine.h"
+
+NTFX_TEST_BEGIN
+
+/**
+ * @brief Fractional delays on the left and right channel. The expected vectors
+ * are the closed form Lagrange coefficients and allpass impulse responses, and
+ * the right channels cover delays below one sample.
+ */
+NTFX_TEST() {
+  auto lagrange          = NtFx::DelayLine<double>();
+  lagrange.interpolation = NtFx::Interpolation::lagrange;
+  lagrange.delay         = { 2.3, 0.4 };
+  NTFX_ADD_TEST(lagrange, "impulse");
+  auto allpass          = NtFx::DelayLine<double>();
+  allpass.interpolation = NtFx::Interpolation::allpass;
+  allpass.delay         = { 2.3, 0.7 };
+  NTFX_ADD_TEST(allpass, "impulse");
+  return NTFX_RUN_TESTS();
+}
@@ -0,0 +1,46 @@
+#include "lib/Comp.h"
+#include "lib/ComponentTest.h"
+#include "lib/GateSc.h"
+#include "lib/utils.h"
+
+NTFX_TEST_BEGIN
+
+/**
+ * @brief Left output is db() of the input, floored at -120 dB. Right output is
+ * invDb() of the input scaled to +-48 dB. The expected vectors are made with
+ * ExactMath, so the tests fail if FastMath is off by more than the accepted
+ * difference of ComponentTest.
+ */
+struct Conversions : public NtFx::Component<NtFx::Stereo<double>> {
+  virtual NtFx::Stereo<double> process(
+      NtFx::Stereo<double> x) noexcept override {
+    return {
+      NtFx::FastMath::db(gcem::abs(x.l) + 1e-6),
+      NtFx::FastMath::invDb(48 * x.r),
+    };
+  }
+};
+
+NTFX_TEST() {
+  auto conversions = Conversions();
+  NTFX_ADD_TEST(conversions, "linearSweep");
+  auto compSettings      = NtFx::Comp::ScSettings<double>();
+  compSettings.ratio_db  = 3;
+  compSettings.knee_db   = 0;
+  compSettings.thresh_db = -6;
+  compSettings.tRel_ms   = 20;
+  auto peakDbSc =
+      NtFx::Comp::PeakSideChainDb<double, NtFx::FastMath>(compSettings);
+  NTFX_ADD_TEST(peakDbSc, "dynamic_alternating");
+  auto rmsScDb =
+      NtFx::Comp::RmsSideChainDb<double, NtFx::FastMath>(compSettings);
+  NTFX_ADD_TEST(rmsScDb, "dynamic_alternating");
+  auto gateSettings      = NtFx::Gate::ScSettings<double>();
+  gateSettings.thresh_db = -6;
+  gateSettings.range_db  = -12;
+  gateSettings.tHold_ms  = 1;
+  gateSettings.tRel_ms   = 10;
+  auto gateSc = NtFx::Gate::Sc<double, NtFx::FastMath>(gateSettings);
+  NTFX_ADD_TEST(gateSc, "dynamic_matched");
+  return NTFX_RUN_TESTS();
+}
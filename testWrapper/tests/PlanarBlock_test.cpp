@@ -0,0 +1,52 @@
+#include "lib/Biquad.h"
+#include "lib/ComponentTest.h"
+#include "lib/PlanarBlock.h"
+#include <vector>
+
+NTFX_TEST_BEGIN
+
+/**
+ * @brief An EqBand run through a PlanarBlock in processBlock(). The work
+ * buffer is shorter than the blocks of the test, so they are split into
+ * chunks, the last one partial. The expected vector is that of the band alone.
+ */
+struct Planar : public NtFx::Component<NtFx::Stereo<double>> {
+  NtFx::Biquad::EqBand<double> band;
+  NtFx::PlanarBlock<double> block;
+  std::vector<double> l, r;
+
+  Planar() { this->block.reserve(7); }
+
+  virtual NtFx::Stereo<double> process(
+      NtFx::Stereo<double> x) noexcept override {
+    return this->band.process(x);
+  }
+
+  virtual void processBlock(const NtFx::Stereo<double>* x,
+      NtFx::Stereo<double>* y,
+      size_t n) noexcept override {
+    this->l.resize(n);
+    this->r.resize(n);
+    NtFx::Simd::deinterleave(x, this->l.data(), this->r.data(), n);
+    this->block.set(this->l.data(), this->r.data(), n);
+    this->block.process(this->band);
+    NtFx::Simd::interleave(this->l.data(), this->r.data(), y, n);
+  }
+
+  virtual void update() noexcept override { this->band.update(); }
+
+  virtual void reset(float fs) noexcept override {
+    this->fs = fs;
+    this->band.reset(fs);
+  }
+};
+
+NTFX_TEST() {
+  auto bell                  = Planar();
+  bell.band.settings.shape   = NtFx::Biquad::Shape::bell;
+  bell.band.settings.gain_db = 12;
+  bell.band.settings.fc_hz   = 4e3;
+  bell.band.settings.q       = 2;
+  NTFX_ADD_TEST(bell, "impulse");
+  return NTFX_RUN_TESTS();
+}
@@ -9,5 +9,9 @@ NTFX_TEST() {
   auto rmsSensor = NtFx::RmsSensorStereo<double>();
   rmsSensor.setT_ms(10);
   NTFX_ADD_TEST(rmsSensor, "dynamic_alternating");
+  auto rmsSensorExp = NtFx::RmsSensorStereo<double>();
+  rmsSensorExp.setT_ms(10);
+  rmsSensorExp.setMode(NtFx::RmsMode::exponential);
+  NTFX_ADD_TEST(rmsSensorExp, "dynamic_alternating");
   return NTFX_RUN_TESTS();
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+// The converter runs the plugin it is built for. The example plugin is unity
+// gain by default, so the tests see the converter alone.
+#define NTFX_PLUGIN gainExample
+#define NTFX_PLUGIN_FILE "plugins/gainExample.h"
+
+#include "lib/ComponentTest.h"
+#include "lib/SampleRateConverter.h"
+#include <array>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+NTFX_TEST_BEGIN
+
+/**
+ * @brief A sample rate converter in one mode as a Component. The expected
+ * vectors are made with process() alone, so the tests fail if processBlock()
+ * does not give the same output.
+ */
+struct Converter : public NtFx::Component<NtFx::Stereo<double>> {
+  gainExample<double> plug;
+  NtFx::Src::SampleRateConverter<double> src;
+
+  Converter(NtFx::Src::oversamplingMode mode) : src(plug) {
+    this->src.mode = mode;
+  }
+
+  virtual NtFx::Stereo<double> process(
+      NtFx::Stereo<double> x) noexcept override {
+    return this->src.process(x);
+  }
+
+  virtual void processBlock(const NtFx::Stereo<double>* x,
+      NtFx::Stereo<double>* y,
+      size_t n) noexcept override {
+    this->src.processBlock(x, y, n);
+  }
+
+  virtual void reset(float fs) noexcept override {
+    this->fs = fs;
+    this->src.reset(fs);
+    this->plug.reset(this->src.coeffs.fsHi);
+  }
+};
+
+/**
+ * @brief Measures the impulse response of every mode in reset(). Sample i of
+ * the output belongs to mode i + 1. Left is the group delay at DC minus the
+ * latency reported to the host, in samples. Right is how much more than
+ * 'passbandRipple_db' the gain strays from unity up to 'fPassband_hz', in dB.
+ * The expected vector is all zeros.
+ */
+struct Measurements : public NtFx::Component<NtFx::Stereo<double>> {
+  static constexpr size_t nModes            = NtFx::Src::end;
+  static constexpr size_t nResponse         = 4096;
+  static constexpr double fPassband_hz      = 10e3;
+  static constexpr double passbandRipple_db = 0.1;
+
+  std::array<NtFx::Stereo<double>, nModes> errors;
+  size_t i = 0;
+
+  virtual NtFx::Stereo<double> process(
+      NtFx::Stereo<double>) noexcept override {
+    if (this->i >= nModes) { return 0.0; }
+    return this->errors[this->i++];
+  }
+
+  virtual void reset(float fs) noexcept override {
+    this->fs = fs;
+    this->i  = 0;
+    for (size_t m = 0; m < nModes; m++) {
+      auto cut = Converter(NtFx::Src::oversamplingMode(m + 1));
+      cut.reset(fs);
+      std::vector<double> h(nResponse);
+      for (size_t j = 0; j < nResponse; j++) {
+        h[j] = cut.process({ j ? 0.0 : 1.0, 0.0 }).l;
+      }
+      double sum = 0, moment = 0;
+      for (size_t j = 0; j < nResponse; j++) {
+        sum += h[j];
+        moment += double(j) * h[j];
+      }
+      double ripple_db = 0;
+      for (double f = 20; f <= fPassband_hz; f *= 1.25) {
+        std::complex<double> acc = 0;
+        for (size_t j = 0; j < nResponse; j++) {
+          acc += h[j] * std::polar(1.0, -2 * M_PI * f / fs * double(j));
+        }
+        const double gain_db = 20 * std::log10(std::abs(acc));
+        ripple_db            = std::max(ripple_db, std::abs(gain_db));
+      }
+      this->errors[m] = {
+        moment / sum - cut.src.getLatencySamples(),
+        std::max(ripple_db - passbandRipple_db, 0.0),
+      };
+    }
+  }
+};
+
+NTFX_TEST() {
+  auto fir_2x_lq = Converter(NtFx::Src::fir_2x_lq);
+  NTFX_ADD_TEST(fir_2x_lq, "impulse");
+  auto fir_4x_lq = Converter(NtFx::Src::fir_4x_lq);
+  NTFX_ADD_TEST(fir_4x_lq, "impulse");
+  auto fir_8x_lq = Converter(NtFx::Src::fir_8x_lq);
+  NTFX_ADD_TEST(fir_8x_lq, "impulse");
+  auto fir_2x_hq = Converter(NtFx::Src::fir_2x_hq);
+  NTFX_ADD_TEST(fir_2x_hq, "impulse");
+  auto fir_4x_hq = Converter(NtFx::Src::fir_4x_hq);
+  NTFX_ADD_TEST(fir_4x_hq, "impulse");
+  auto fir_8x_hq = Converter(NtFx::Src::fir_8x_hq);
+  NTFX_ADD_TEST(fir_8x_hq, "impulse");
+  auto hb_2x = Converter(NtFx::Src::hb_2x);
+  NTFX_ADD_TEST(hb_2x, "impulse");
+  auto hb_4x = Converter(NtFx::Src::hb_4x);
+  NTFX_ADD_TEST(hb_4x, "impulse");
+  auto hb_8x = Converter(NtFx::Src::hb_8x);
+  NTFX_ADD_TEST(hb_8x, "impulse");
+  auto hb_16x = Converter(NtFx::Src::hb_16x);
+  NTFX_ADD_TEST(hb_16x, "impulse");
+  auto iir_2x = Converter(NtFx::Src::iir_2x);
+  NTFX_ADD_TEST(iir_2x, "impulse");
+  auto iir_4x = Converter(NtFx::Src::iir_4x);
+  NTFX_ADD_TEST(iir_4x, "impulse");
+  auto iir_8x = Converter(NtFx::Src::iir_8x);
+  NTFX_ADD_TEST(iir_8x, "impulse");
+  auto measurements = Measurements();
+  NTFX_ADD_TEST(measurements, "impulse");
+  return NTFX_RUN_TESTS();
+}
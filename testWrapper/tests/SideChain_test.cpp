@@ -15,6 +15,11 @@ NTFX_TEST() {
   peakSettings1.linkEnable = true;
   auto peakDbScLink        = NtFx::Comp::PeakSideChainDb<double>(peakSettings1);
   NTFX_ADD_TEST(peakDbScLink, "dynamic_alternating");
+  auto lookaheadSettings          = sharedSettings;
+  lookaheadSettings.tLookahead_ms = 2;
+  auto peakDbScLookahead
+      = NtFx::Comp::PeakSideChainDb<double>(lookaheadSettings);
+  NTFX_ADD_TEST(peakDbScLookahead, "dynamic_alternating");
   auto rmsSettings    = sharedSettings;
   rmsSettings.tRms_ms = 10;
   rmsSettings.tAtt_ms = 10;
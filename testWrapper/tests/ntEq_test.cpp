@@ -0,0 +1,21 @@
+#include "lib/ComponentTest.h"
+#include "plugins/ntEq.h"
+
+NTFX_TEST_BEGIN
+
+NTFX_TEST() {
+  auto eq_default          = ntEq<double>();
+  auto eq_boosted          = ntEq<double>();
+  eq_boosted.shape         = { 3, 1, 0, 0, 5, 0, 2, 4 };
+  eq_boosted.fc_hz         = { 40, 120, 300, 800, 2e3, 4e3, 8e3, 16e3 };
+  eq_boosted.gain_db       = { 0, 6, -3, 4, 0, -8, 3, 0 };
+  eq_boosted.q             = { 0.707, 0.707, 1, 2, 4, 0.5, 0.707, 0.707 };
+  eq_boosted.outputGain_db = -6;
+  auto eq_bypass           = eq_boosted;
+  eq_bypass.bypassEnable   = true;
+
+  NTFX_ADD_TEST(eq_default, "impulse");
+  NTFX_ADD_TEST(eq_boosted, "impulse");
+  NTFX_ADD_TEST(eq_bypass, "impulse");
+  return NTFX_RUN_TESTS();
+}
@@ -0,0 +1,20 @@
+#include "lib/ComponentTest.h"
+#include "plugins/ntLimiter.h"
+
+NTFX_TEST_BEGIN
+
+NTFX_TEST() {
+  auto limiter                             = ntLimiter<double>();
+  limiter.input_db                         = 6;
+  limiter.scSettings.thresh_db             = -6;
+  auto limiter_samplePeak                  = ntLimiter<double>();
+  limiter_samplePeak.input_db              = 6;
+  limiter_samplePeak.scSettings.thresh_db  = -6;
+  limiter_samplePeak.scSettings.linkEnable = false;
+  limiter_samplePeak.sc.truePeakEnable     = false;
+
+  NTFX_ADD_TEST(limiter, "dynamic_alternating");
+  NTFX_ADD_TEST(limiter_samplePeak, "dynamic_alternating");
+  NTFX_ADD_TEST(limiter, "linearSweep");
+  return NTFX_RUN_TESTS();
+}